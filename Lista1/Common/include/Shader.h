@@ -7,6 +7,8 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <unordered_map>
+#include <cstring>
 
 //GLAD
 #include <glad/glad.h>
@@ -14,12 +16,29 @@
 // GLFW
 #include <GLFW/glfw3.h>
 
+// Cache de binários de programa
+#include "ProgramCache.h"
+
 using namespace std;
 
+// Cada Shader guarda uma cópia (sombra) do último valor enviado para cada uniform e não
+// repete glUniform* quando o valor é o mesmo. A sombra só é válida se todo envio para o
+// programa passar por este objeto: use um único Shader por programa e chame invalidate()
+// depois de escrever uniforms por fora (glUniform* direto) ou de relinkar o programa.
+// Como antes, os set* valem para o programa em uso (Use()).
 class Shader
 {
 public:
+	// Contadores de envio de uniforms, somados para todos os shaders
+	struct UniformStats
+	{
+		int sent = 0;    // chamadas glUniform* realmente feitas
+		int skipped = 0; // chamadas evitadas porque o valor não mudou
+	};
+
 	GLuint ID;
+	// Usa um programa já montado (por exemplo, vindo da ShaderLibrary)
+	Shader(GLuint program) : ID(program) {}
 	// Constructor generates the shader on the fly
 	Shader(const GLchar* vertexPath, const GLchar* fragmentPath)
 	{
@@ -51,50 +70,8 @@ public:
 		{
 			std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
 		}
-		const GLchar* vShaderCode = vertexCode.c_str();
-		const GLchar * fShaderCode = fragmentCode.c_str();
-		// 2. Compile shaders
-		GLuint vertex, fragment;
-		GLint success;
-		GLchar infoLog[512];
-		// Vertex Shader
-		vertex = glCreateShader(GL_VERTEX_SHADER);
-		glShaderSource(vertex, 1, &vShaderCode, NULL);
-		glCompileShader(vertex);
-		// Print compile errors if any
-		glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-		if (!success)
-		{
-			glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-			std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-		}
-		// Fragment Shader
-		fragment = glCreateShader(GL_FRAGMENT_SHADER);
-		glShaderSource(fragment, 1, &fShaderCode, NULL);
-		glCompileShader(fragment);
-		// Print compile errors if any
-		glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-		if (!success)
-		{
-			glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-			std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-		}
-		// Shader Program
-		this->ID = glCreateProgram();
-		glAttachShader(this->ID, vertex);
-		glAttachShader(this->ID, fragment);
-		glLinkProgram(this->ID);
-		// Print linking errors if any
-		glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
-		if (!success)
-		{
-			glGetProgramInfoLog(this->ID, 512, NULL, infoLog);
-			std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-		}
-		// Delete the shaders as they're linked into our program now and no longer necessery
-		glDeleteShader(vertex);
-		glDeleteShader(fragment);
-
+		// 2. Build the program: cached binary when available, compiled from source otherwise
+		this->ID = ProgramCache::build(vertexCode, fragmentCode);
 	}
 	// Uses the current shader
 	void Use()
@@ -104,38 +81,110 @@ public:
 
 	void setBool(const std::string& name, bool value) const
 	{
-		glUniform1i(glGetUniformLocation(this->ID, name.c_str()), (int)value);
+		int v = (int)value;
+		GLint location = changed(name, &v, sizeof(v));
+		if (location >= 0) glUniform1i(location, v);
 	}
 	// ------------------------------------------------------------------------
 	void setInt(const std::string& name, int value) const
 	{
-		glUniform1i(glGetUniformLocation(this->ID, name.c_str()), value);
+		GLint location = changed(name, &value, sizeof(value));
+		if (location >= 0) glUniform1i(location, value);
 	}
 	// ------------------------------------------------------------------------
 	void setFloat(const std::string& name, float value) const
 	{
-		glUniform1f(glGetUniformLocation(this->ID, name.c_str()), value);
+		GLint location = changed(name, &value, sizeof(value));
+		if (location >= 0) glUniform1f(location, value);
 	}
 	// ------------------------------------------------------------------------
 	void setVec2(const std::string& name, float v1, float v2) const
 	{
-		glUniform2f(glGetUniformLocation(this->ID, name.c_str()), v1, v2);
+		float v[2] = { v1, v2 };
+		GLint location = changed(name, v, sizeof(v));
+		if (location >= 0) glUniform2f(location, v1, v2);
 	}
 
 	// ------------------------------------------------------------------------
 	void setVec3(const std::string& name, float v1, float v2, float v3) const
 	{
-		glUniform3f(glGetUniformLocation(this->ID, name.c_str()), v1, v2, v3);
+		float v[3] = { v1, v2, v3 };
+		GLint location = changed(name, v, sizeof(v));
+		if (location >= 0) glUniform3f(location, v1, v2, v3);
 	}
 
 	void setVec4(const std::string& name, float v1, float v2, float v3, float v4) const
 	{
-		glUniform4f(glGetUniformLocation(this->ID, name.c_str()), v1, v2, v3,v4);
+		float v[4] = { v1, v2, v3, v4 };
+		GLint location = changed(name, v, sizeof(v));
+		if (location >= 0) glUniform4f(location, v1, v2, v3, v4);
+	}
+
+	void setMat4(const std::string& name, const float *v) const
+	{
+		GLint location = changed(name, v, 16 * sizeof(float));
+		if (location >= 0) glUniformMatrix4fv(location, 1, GL_FALSE, v);
 	}
 
-	void setMat4(const std::string& name, float *v) const
+	// Esquece os valores guardados: o próximo set* de cada uniform sempre envia
+	void invalidate()
 	{
-		glUniformMatrix4fv(glGetUniformLocation(this->ID, name.c_str()), 1, GL_FALSE, v);
+		for (auto& entry : uniforms)
+		{
+			entry.second.size = 0;
+		}
+	}
+
+	// Contadores do frame atual
+	static UniformStats& frameStats()
+	{
+		static UniformStats stats;
+		return stats;
+	}
+
+	// Fecha o frame (chamar depois do glfwSwapBuffers): zera os contadores e retorna quantos
+	// envios foram feitos e evitados no frame que acabou
+	static UniformStats endFrame()
+	{
+		UniformStats frame = frameStats();
+		frameStats() = UniformStats();
+		return frame;
+	}
+
+private:
+	struct Uniform
+	{
+		GLint location = -1;
+		bool located = false;
+		size_t size = 0;        // 0 = nenhum valor conhecido
+		unsigned char value[16 * sizeof(float)];
+	};
+
+	mutable std::unordered_map<std::string, Uniform> uniforms;
+
+	// Retorna a location se o valor mudou (e atualiza a sombra) ou -1 se o envio pode ser
+	// evitado (valor igual ao último enviado, ou uniform inexistente no programa)
+	GLint changed(const std::string& name, const void* value, size_t size) const
+	{
+		Uniform& uniform = uniforms[name];
+		if (!uniform.located)
+		{
+			uniform.location = glGetUniformLocation(this->ID, name.c_str());
+			uniform.located = true;
+		}
+		if (uniform.location < 0)
+		{
+			return -1;
+		}
+		if (uniform.size == size && memcmp(uniform.value, value, size) == 0)
+		{
+			frameStats().skipped++;
+			return -1;
+		}
+		memcpy(uniform.value, value, size);
+		uniform.size = size;
+		frameStats().sent++;
+		return uniform.location;
 	}
 };
 
@@ -0,0 +1,291 @@
+// Biblioteca central de programas de shader, usada pelo setupShader() de todos os programas
+// Os programas são submetidos de uma vez (submit) e o driver os compila em paralelo quando
+// tem GL_KHR_parallel_shader_compile (ou a versão ARB): o andamento é consultado com
+// GL_COMPLETION_STATUS, sem travar em glGetShaderiv logo depois de cada compilação.
+// Cada submit devolve um ShaderFuture: o primeiro frame pode começar assim que os programas
+// que ele usa estiverem prontos, enquanto os outros terminam de linkar.
+// Os programas linkados passam pelo ProgramCache (binário em disco).
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <chrono>
+
+//GLAD
+#include <glad/glad.h>
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+#include "ProgramCache.h"
+
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+class ShaderLibrary;
+
+// Resultado de um submit: consulta sem bloquear (isReady) ou espera o programa (get)
+class ShaderFuture
+{
+public:
+	ShaderFuture() {}
+	ShaderFuture(ShaderLibrary* library, int index) : library(library), index(index) {}
+
+	bool valid() const { return library != nullptr; }
+	inline bool isReady() const;
+	inline GLuint get() const;
+
+private:
+	ShaderLibrary* library = nullptr;
+	int index = -1;
+};
+
+class ShaderLibrary
+{
+public:
+	// Instância única, compartilhada por todo o programa
+	static ShaderLibrary& get()
+	{
+		static ShaderLibrary library;
+		return library;
+	}
+
+	// Submete um programa para compilação; não espera o resultado
+	ShaderFuture submit(const std::string& name, const std::string& vertexCode, const std::string& fragmentCode,
+		const std::string& defines = "")
+	{
+		init();
+
+		Entry entry;
+		entry.name = name;
+		entry.start = std::chrono::steady_clock::now();
+
+		std::string vs = ProgramCache::injectDefines(vertexCode, defines);
+		std::string fs = ProgramCache::injectDefines(fragmentCode, defines);
+		entry.key = ProgramCache::keyFor(vs, fs, defines);
+
+		entry.program = ProgramCache::tryLoad(entry.key);
+		if (entry.program)
+		{
+			entry.fromCache = true;
+			entries.push_back(entry);
+			finish((int)entries.size() - 1);
+			return ShaderFuture(this, (int)entries.size() - 1);
+		}
+
+		// Dispara compilação e link sem consultar nenhum status
+		const GLchar* vShaderCode = vs.c_str();
+		const GLchar* fShaderCode = fs.c_str();
+		entry.vertex = glCreateShader(GL_VERTEX_SHADER);
+		glShaderSource(entry.vertex, 1, &vShaderCode, NULL);
+		glCompileShader(entry.vertex);
+		entry.fragment = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(entry.fragment, 1, &fShaderCode, NULL);
+		glCompileShader(entry.fragment);
+
+		entry.program = glCreateProgram();
+		glAttachShader(entry.program, entry.vertex);
+		glAttachShader(entry.program, entry.fragment);
+		ProgramCache::markRetrievable(entry.program);
+		glLinkProgram(entry.program);
+
+		entries.push_back(entry);
+		return ShaderFuture(this, (int)entries.size() - 1);
+	}
+
+	// Verifica, sem bloquear, se o programa terminou. Sem a extensão de compilação paralela
+	// não há como consultar sem esperar, então a primeira consulta conclui o programa
+	bool isReady(int index)
+	{
+		Entry& entry = entries[index];
+		if (entry.ready)
+		{
+			return true;
+		}
+		if (parallel)
+		{
+			GLint done = GL_FALSE;
+			glGetProgramiv(entry.program, GL_COMPLETION_STATUS_KHR, &done);
+			if (!done)
+			{
+				return false;
+			}
+		}
+		finish(index);
+		return true;
+	}
+
+	// Espera o programa ficar pronto e retorna o identificador
+	GLuint wait(int index)
+	{
+		if (!entries[index].ready)
+		{
+			finish(index);
+		}
+		return entries[index].program;
+	}
+
+	// Consulta todos os programas pendentes (chamar uma vez por frame); retorna quantos faltam
+	int poll()
+	{
+		int pending = 0;
+		for (int i = 0; i < (int)entries.size(); i++)
+		{
+			if (!isReady(i))
+			{
+				pending++;
+			}
+		}
+		return pending;
+	}
+
+	void waitAll()
+	{
+		for (int i = 0; i < (int)entries.size(); i++)
+		{
+			wait(i);
+		}
+	}
+
+	// Liga o bloco uniforme com esse nome ao ponto de ligação em todos os programas que o
+	// declaram, inclusive nos que ainda vão ficar prontos
+	void bindUniformBlock(const std::string& blockName, GLuint binding)
+	{
+		blockBindings.push_back(BlockBinding{ blockName, binding });
+		for (Entry& entry : entries)
+		{
+			if (entry.ready)
+			{
+				applyBlockBinding(entry.program, blockBindings.back());
+			}
+		}
+	}
+
+	bool hasParallelCompile() const { return parallel; }
+
+private:
+	typedef void (APIENTRYP MaxShaderCompilerThreadsProc)(GLuint count);
+
+	struct Entry
+	{
+		std::string name, key;
+		GLuint program = 0, vertex = 0, fragment = 0;
+		bool ready = false, fromCache = false;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	struct BlockBinding
+	{
+		std::string name;
+		GLuint binding;
+	};
+
+	std::vector<Entry> entries;
+	std::vector<BlockBinding> blockBindings;
+	bool initialized = false;
+	bool parallel = false;
+
+	ShaderLibrary() {}
+
+	void init()
+	{
+		if (initialized)
+		{
+			return;
+		}
+		initialized = true;
+		ProgramCache::init();
+
+		MaxShaderCompilerThreadsProc maxThreads = nullptr;
+		if (glfwExtensionSupported("GL_KHR_parallel_shader_compile"))
+		{
+			maxThreads = (MaxShaderCompilerThreadsProc)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+		}
+		else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+		{
+			maxThreads = (MaxShaderCompilerThreadsProc)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+		}
+		if (maxThreads)
+		{
+			// 0xFFFFFFFF: o driver escolhe quantas threads usar
+			maxThreads(0xFFFFFFFF);
+			parallel = true;
+		}
+		std::cout << "ShaderLibrary: compilacao paralela " << (parallel ? "disponivel" : "indisponivel") << std::endl;
+	}
+
+	void applyBlockBinding(GLuint program, const BlockBinding& block)
+	{
+		GLuint index = glGetUniformBlockIndex(program, block.name.c_str());
+		if (index != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(program, index, block.binding);
+		}
+	}
+
+	// Confere os erros, libera os shaders e salva o binário no cache
+	void finish(int index)
+	{
+		Entry& entry = entries[index];
+		GLint success;
+		GLchar infoLog[512];
+
+		if (!entry.fromCache)
+		{
+			glGetShaderiv(entry.vertex, GL_COMPILE_STATUS, &success);
+			if (!success)
+			{
+				glGetShaderInfoLog(entry.vertex, 512, NULL, infoLog);
+				std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED (" << entry.name << ")\n" << infoLog << std::endl;
+			}
+			glGetShaderiv(entry.fragment, GL_COMPILE_STATUS, &success);
+			if (!success)
+			{
+				glGetShaderInfoLog(entry.fragment, 512, NULL, infoLog);
+				std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED (" << entry.name << ")\n" << infoLog << std::endl;
+			}
+			glGetProgramiv(entry.program, GL_LINK_STATUS, &success);
+			if (!success)
+			{
+				glGetProgramInfoLog(entry.program, 512, NULL, infoLog);
+				std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED (" << entry.name << ")\n" << infoLog << std::endl;
+			}
+			else
+			{
+				ProgramCache::store(entry.key, entry.program);
+			}
+			glDeleteShader(entry.vertex);
+			glDeleteShader(entry.fragment);
+			entry.vertex = entry.fragment = 0;
+		}
+
+		for (const BlockBinding& block : blockBindings)
+		{
+			applyBlockBinding(entry.program, block);
+		}
+
+		entry.ready = true;
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - entry.start).count();
+		ProgramCache::Stats& stats = ProgramCache::state().stats;
+		(entry.fromCache ? stats.hits : stats.misses)++;
+		stats.seconds += seconds;
+		std::cout << "Shader " << entry.name << ": pronto em " << seconds * 1000.0 << " ms ("
+			<< (entry.fromCache ? "cache quente, binario carregado" : "cache frio, compilado") << ")" << std::endl;
+	}
+};
+
+inline bool ShaderFuture::isReady() const
+{
+	return library && library->isReady(index);
+}
+
+inline GLuint ShaderFuture::get() const
+{
+	return library ? library->wait(index) : 0;
+}
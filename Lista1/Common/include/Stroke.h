@@ -0,0 +1,314 @@
+// Tesselação de linhas largas na CPU
+// glLineWidth acima de 1 não existe no core profile e muitos drivers limitam a largura ou
+// caem num caminho lento; glPointSize tem o mesmo problema. Aqui as linhas (strips e loops)
+// e os pontos viram triângulos comuns (GL_TRIANGLES, x, y em float por vértice), que
+// qualquer shader desenha com glDrawArrays.
+// Cada segmento vira um retângulo de largura width; nos vértices internos entra a junção do
+// lado de fora da curva (miter, round ou bevel) e nas pontas de uma linha aberta a ponta
+// (butt, square ou round). As sobreposições entre retângulo e junção não aparecem com cor
+// sólida.
+// A tesselação tem duas passagens: a primeira copia os pontos para arrays SoA (descartando
+// pontos repetidos) e calcula a direção unitária de cada segmento; a segunda só monta os
+// triângulos. As direções não dependem umas das outras e, em linhas longas, saem de 4 em 4
+// com SSE2 (directionsSSE2), escolhido em tempo de execução como no ChainSolver; fora do
+// x86, ou sem SSE2, fica a versão escalar. Os arrays de trabalho são reaproveitados entre
+// chamadas, então linhas longas tesseladas a cada frame não alocam memória depois da
+// primeira.
+
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+//GLAD
+#include <glad/glad.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STROKE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Stroke
+{
+	// Conjunto de instruções usado no cálculo das direções
+	enum Isa { SCALAR, SSE2 };
+
+	inline Isa detectIsa()
+	{
+#ifdef STROKE_X86
+		static const Isa isa = []()
+		{
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("sse2")) return SSE2;
+			return SCALAR;
+		}();
+		return isa;
+#else
+		return SCALAR;
+#endif
+	}
+
+	// Linhas com menos segmentos que isso usam só a versão escalar
+	const size_t SIMD_MIN_SEGMENTS = 16;
+
+	enum Join { JOIN_MITER, JOIN_ROUND, JOIN_BEVEL };
+	enum Cap { CAP_BUTT, CAP_SQUARE, CAP_ROUND };
+
+	struct Style
+	{
+		float width = 1.0f;
+		Join join = JOIN_MITER;
+		Cap cap = CAP_BUTT;
+		float miterLimit = 4.0f; // miter mais longo que miterLimit * width / 2 vira bevel
+		int roundSegments = 8;   // divisões de meia volta nas junções e pontas redondas
+	};
+
+	// Arrays de trabalho (SoA), reaproveitados entre chamadas
+	struct Scratch
+	{
+		std::vector<float> x, y;   // pontos sem repetições
+		std::vector<float> dx, dy; // direção unitária de cada segmento
+	};
+
+	inline Scratch& scratch()
+	{
+		static thread_local Scratch s;
+		return s;
+	}
+
+	// Direção unitária dos segmentos [first, segments): do ponto i para o ponto i + 1
+	inline void directionsScalar(const float* x, const float* y, float* dx, float* dy, size_t first, size_t segments)
+	{
+		for (size_t i = first; i < segments; i++)
+		{
+			float ex = x[i + 1] - x[i], ey = y[i + 1] - y[i];
+			float inverse = 1.0f / std::sqrt(ex * ex + ey * ey);
+			dx[i] = ex * inverse;
+			dy[i] = ey * inverse;
+		}
+	}
+
+#ifdef STROKE_X86
+	// SSE2: 4 segmentos por iteração (sqrt e divisão exatas, mesmo resultado da escalar)
+	__attribute__((target("sse2")))
+	inline void directionsSSE2(const float* x, const float* y, float* dx, float* dy, size_t segments)
+	{
+		const __m128 one = _mm_set1_ps(1.0f);
+		size_t i = 0;
+		for (; i + 4 <= segments; i += 4)
+		{
+			__m128 ex = _mm_sub_ps(_mm_loadu_ps(x + i + 1), _mm_loadu_ps(x + i));
+			__m128 ey = _mm_sub_ps(_mm_loadu_ps(y + i + 1), _mm_loadu_ps(y + i));
+			__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)));
+			__m128 inverse = _mm_div_ps(one, length);
+			_mm_storeu_ps(dx + i, _mm_mul_ps(ex, inverse));
+			_mm_storeu_ps(dy + i, _mm_mul_ps(ey, inverse));
+		}
+		directionsScalar(x, y, dx, dy, i, segments);
+	}
+#endif
+
+	inline void directions(const float* x, const float* y, float* dx, float* dy, size_t segments, Isa isa = detectIsa())
+	{
+#ifdef STROKE_X86
+		if (isa >= SSE2 && segments >= SIMD_MIN_SEGMENTS) { directionsSSE2(x, y, dx, dy, segments); return; }
+#endif
+		directionsScalar(x, y, dx, dy, 0, segments);
+	}
+
+	template <class Vector>
+	void pushTriangle(Vector& out, float ax, float ay, float bx, float by, float cx, float cy)
+	{
+		GLfloat t[] = { ax, ay, bx, by, cx, cy };
+		out.insert(out.end(), t, t + 6);
+	}
+
+	// Leque em torno de (cx, cy), girando o vetor (vx, vy) de angle radianos
+	template <class Vector>
+	void pushFan(Vector& out, float cx, float cy, float vx, float vy, float angle, int roundSegments)
+	{
+		const float PI = 3.14159265f;
+		int steps = std::max(1, (int)std::ceil(std::fabs(angle) / PI * roundSegments));
+		float stepCos = std::cos(angle / steps), stepSin = std::sin(angle / steps);
+		for (int i = 0; i < steps; i++)
+		{
+			float nx = vx * stepCos - vy * stepSin;
+			float ny = vx * stepSin + vy * stepCos;
+			pushTriangle(out, cx, cy, cx + vx, cy + vy, cx + nx, cy + ny);
+			vx = nx;
+			vy = ny;
+		}
+	}
+
+	// Junção no ponto (px, py) entre o segmento de direção (ax, ay) e o de direção (bx, by)
+	template <class Vector>
+	void pushJoin(Vector& out, float px, float py, float ax, float ay, float bx, float by, float h, const Style& style)
+	{
+		float cross = ax * by - ay * bx;
+		float dot = ax * bx + ay * by;
+		if (std::fabs(cross) < 1.0e-6f && dot > 0.0f)
+		{
+			return; // segmentos alinhados: os retângulos já se encostam
+		}
+		// Lado de fora: direita numa curva à esquerda (cross > 0), esquerda na outra
+		float side = cross > 0.0f ? -1.0f : 1.0f;
+		// Normais (esquerda) dos dois segmentos, do lado de fora
+		float ox = -ay * side * h, oy = ax * side * h;
+		float qx = -by * side * h, qy = bx * side * h;
+
+		if (style.join == JOIN_ROUND)
+		{
+			pushFan(out, px, py, ox, oy, std::atan2(cross, dot), style.roundSegments);
+			return;
+		}
+		if (style.join == JOIN_MITER)
+		{
+			// Bissetriz das normais; o miter tem comprimento h / cos(metade do ângulo)
+			float mx = ox + qx, my = oy + qy;
+			float m2 = mx * mx + my * my;
+			// |m|^2 = 2 h^2 (1 + cos): o miter mede 2 h^2 / |m|
+			if (m2 > 0.0f && 4.0f * h * h <= style.miterLimit * style.miterLimit * m2)
+			{
+				float scale = 2.0f * h * h / m2;
+				float tipX = px + mx * scale, tipY = py + my * scale;
+				pushTriangle(out, px, py, px + ox, py + oy, tipX, tipY);
+				pushTriangle(out, px, py, tipX, tipY, px + qx, py + qy);
+				return;
+			}
+		}
+		pushTriangle(out, px, py, px + ox, py + oy, px + qx, py + qy);
+	}
+
+	// Acrescenta em out os triângulos da linha que passa por count pontos. Os pontos são lidos
+	// de points com stride floats entre um e outro (2 para x, y; 3 para x, y, z, com z
+	// ignorado). closed = true fecha a linha como GL_LINE_LOOP. out é um vector de GLfloat
+	// (ou outro container com insert, reserve e size). Retorna os vértices acrescentados
+	template <class Vector>
+	size_t polyline(const GLfloat* points, size_t count, size_t stride, bool closed, const Style& style, Vector& out)
+	{
+		Scratch& s = scratch();
+		size_t before = out.size();
+
+		// Passagem 1: pontos sem repetições, em SoA
+		s.x.resize(count + 1);
+		s.y.resize(count + 1);
+		size_t n = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			float px = points[i * stride], py = points[i * stride + 1];
+			if (n == 0 || px != s.x[n - 1] || py != s.y[n - 1])
+			{
+				s.x[n] = px;
+				s.y[n] = py;
+				n++;
+			}
+		}
+		if (closed && n > 1 && s.x[n - 1] == s.x[0] && s.y[n - 1] == s.y[0])
+		{
+			n--;
+		}
+		if (n < 2)
+		{
+			return 0;
+		}
+		if (closed)
+		{
+			// O segmento de volta sai do último ponto para o primeiro
+			s.x[n] = s.x[0];
+			s.y[n] = s.y[0];
+		}
+		size_t segments = closed ? n : n - 1;
+
+		// Direções unitárias (SSE2 em linhas longas)
+		s.dx.resize(segments);
+		s.dy.resize(segments);
+		const float* x = s.x.data();
+		const float* y = s.y.data();
+		float* dx = s.dx.data();
+		float* dy = s.dy.data();
+		directions(x, y, dx, dy, segments);
+
+		// Passagem 2: triângulos
+		float h = 0.5f * style.width;
+		out.reserve(out.size() + 12 * segments + 6 * n * (style.join == JOIN_ROUND ? style.roundSegments : 2));
+		for (size_t i = 0; i < segments; i++)
+		{
+			float nx = -dy[i] * h, ny = dx[i] * h;
+			float ax = x[i], ay = y[i], bx = x[i + 1], by = y[i + 1];
+			pushTriangle(out, ax + nx, ay + ny, ax - nx, ay - ny, bx + nx, by + ny);
+			pushTriangle(out, ax - nx, ay - ny, bx - nx, by - ny, bx + nx, by + ny);
+
+			// Junção com o próximo segmento (na linha fechada, o último junta com o primeiro)
+			if (i + 1 < segments || closed)
+			{
+				size_t next = (i + 1) % segments;
+				pushJoin(out, bx, by, dx[i], dy[i], dx[next], dy[next], h, style);
+			}
+		}
+
+		if (!closed && style.cap != CAP_BUTT)
+		{
+			size_t last = segments - 1;
+			float sx = x[0], sy = y[0], ex = x[n - 1], ey = y[n - 1];
+			if (style.cap == CAP_ROUND)
+			{
+				// Meia volta da esquerda para a direita passando por trás do início, e da
+				// direita para a esquerda passando pela frente do fim
+				const float PI = 3.14159265f;
+				pushFan(out, sx, sy, -dy[0] * h, dx[0] * h, PI, style.roundSegments);
+				pushFan(out, ex, ey, dy[last] * h, -dx[last] * h, PI, style.roundSegments);
+			}
+			else
+			{
+				// Retângulo de h além de cada ponta
+				float nx = -dy[0] * h, ny = dx[0] * h;
+				float bx = sx - dx[0] * h, by = sy - dy[0] * h;
+				pushTriangle(out, bx + nx, by + ny, bx - nx, by - ny, sx + nx, sy + ny);
+				pushTriangle(out, bx - nx, by - ny, sx - nx, sy - ny, sx + nx, sy + ny);
+				nx = -dy[last] * h;
+				ny = dx[last] * h;
+				bx = ex + dx[last] * h;
+				by = ey + dy[last] * h;
+				pushTriangle(out, ex + nx, ey + ny, ex - nx, ey - ny, bx + nx, by + ny);
+				pushTriangle(out, ex - nx, ey - ny, bx - nx, by - ny, bx + nx, by + ny);
+			}
+		}
+		return (out.size() - before) / 2;
+	}
+
+	// Acrescenta em out um quadrado de lado size centrado em cada ponto (como GL_POINTS com
+	// glPointSize(size)). Retorna os vértices acrescentados
+	template <class Vector>
+	size_t dots(const GLfloat* points, size_t count, size_t stride, float size, Vector& out)
+	{
+		float h = 0.5f * size;
+		out.reserve(out.size() + 12 * count);
+		for (size_t i = 0; i < count; i++)
+		{
+			float px = points[i * stride], py = points[i * stride + 1];
+			pushTriangle(out, px - h, py + h, px - h, py - h, px + h, py + h);
+			pushTriangle(out, px - h, py - h, px + h, py - h, px + h, py + h);
+		}
+		return 6 * count;
+	}
+
+	// Cria VAO e VBO com os triângulos (atributo 0, x, y em float)
+	template <class Vector>
+	GLuint createVAO(const Vector& triangles)
+	{
+		GLuint VBO, VAO;
+		glGenBuffers(1, &VBO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, triangles.size() * sizeof(GLfloat), triangles.data(), GL_STATIC_DRAW);
+
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid*)0);
+		glEnableVertexAttribArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+		return VAO;
+	}
+}
@@ -22,6 +22,12 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
+// Biblioteca de shaders (Common/include)
+#include "ShaderLibrary.h"
+
+// Malhas procedurais em cache (Common/include)
+#include "MeshLibrary.h"
+
 
 const float Pi = 3.14159265358979323846;
 
@@ -32,7 +38,6 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 // Protótipos das funções
 int setupShader();
 int setupGeometry();
-int createCircle(int nPoints, float radius = 0.5);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 600, HEIGHT = 600;
@@ -105,10 +110,11 @@ int main()
 
 	int nPoints = 8;
 
-	// Gerando um buffer simples, com a geometria de um triângulo
-	GLuint VAO = createCircle(nPoints);
+	// Círculo da biblioteca de malhas (gerado uma vez só e compartilhado)
+	const Mesh& circle = MeshLibrary::get().circle(nPoints);
+	GLuint VAO = circle.VAO;
 
-	int nVertices = nPoints + 2; // inclui o centro e o extra (repetição do primeiro)
+	int nVertices = circle.count; // inclui o centro e o extra (repetição do primeiro)
 
 	// Enviando a cor desejada (vec4) para o fragment shader
 	// Utilizamos a variáveis do tipo uniform em GLSL para armazenar esse tipo de info
@@ -156,8 +162,7 @@ int main()
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
 	}
-	// Pede pra OpenGL desalocar os buffers
-	glDeleteVertexArrays(1, &VAO);
+	// Os buffers da malha pertencem à biblioteca de malhas
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
 	return 0;
@@ -179,45 +184,9 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 // A função retorna o identificador do programa de shader
 int setupShader()
 {
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success) {
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
+	// Submete o programa à biblioteca de shaders (compilação assíncrona e cache de binários)
+	// e espera até ele ficar pronto
+	return ShaderLibrary::get().submit("lista1ex6a", vertexShaderSource, fragmentShaderSource).get();
 }
 
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a 
@@ -271,64 +240,5 @@ int setupGeometry()
 	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
 	glBindVertexArray(0); 
 
-	return VAO;
-}
-
-int createCircle(int nPoints, float radius)
-{
-	vector <GLfloat> vertices;
-
-	float angle = 0.0;
-	float slice = 2 * Pi / (float)nPoints;
-
-	//Adicionar o ponto da origem (0.0, 0.0, 0.0) como sendo o centro do círculo
-	vertices.push_back(0.0); //Xc
-	vertices.push_back(0.0); //Yc
-	vertices.push_back(0.0); //Zc
-
-	for (int i = 0; i < nPoints + 1; i++)
-	{
-		float x = radius * cos(angle);
-		float y = radius * sin(angle);
-		float z = 0.0;
-
-		vertices.push_back(x);
-		vertices.push_back(y);
-		vertices.push_back(z);
-
-		angle = angle + slice;
-	}
-
-	//Configuração dos buffers VBO e VAO
-	GLuint VBO, VAO;
-	//Geração do identificador do VBO
-	glGenBuffers(1, &VBO);
-	//Faz a conexão (vincula) do buffer como um buffer de array
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	//Envia os dados do array de floats para o buffer da OpenGl
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
-
-	//Geração do identificador do VAO (Vertex Array Object)
-	glGenVertexArrays(1, &VAO);
-	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-	// e os ponteiros para os atributos 
-	glBindVertexArray(VAO);
-	//Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando: 
-	// Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-	// Numero de valores que o atributo tem (por ex, 3 coordenadas xyz) 
-	// Tipo do dado
-	// Se está normalizado (entre zero e um)
-	// Tamanho em bytes 
-	// Deslocamento a partir do byte zero 
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
-	glEnableVertexAttribArray(0);
-
-	// Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice 
-	// atualmente vinculado - para que depois possamos desvincular com segurança
-	glBindBuffer(GL_ARRAY_BUFFER, 0); 
-
-	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0); 
-
 	return VAO;
 }
\ No newline at end of file
@@ -22,6 +22,15 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
+// Biblioteca de shaders (Common/include)
+#include "ShaderLibrary.h"
+
+// Malhas procedurais em cache (Common/include)
+#include "MeshLibrary.h"
+
+// Linhas largas em triângulos (Common/include)
+#include "Stroke.h"
+
 
 const float Pi = 3.14159265358979323846;
 
@@ -32,7 +41,6 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 // Protótipos das funções
 int setupShader();
 int setupGeometry();
-int createSpiral(int nPoints);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 600, HEIGHT = 600;
@@ -103,12 +111,20 @@ int main()
 	// Compilando e buildando o programa de shader
 	GLuint shaderID = setupShader();
 
-	int nPoints = 110;
-
-	// Gerando um buffer simples, com a geometria de um triângulo
-	GLuint VAO = createSpiral(nPoints);
-
-	int nVertices = nPoints;
+	// Espiral: 3 voltas de 36 pontos (10 graus) e o ponto final, o raio cresce 0.005 por ponto
+	int nSpiralPoints = 3 * 36 + 1;
+	vector<GLfloat> spiralPoints(2 * nSpiralPoints);
+	MeshLibrary::generateSpiral(spiralPoints.data(), nSpiralPoints, 0.0f, 0.0f, 0.0f, 0.005f, 0.0f, 2.0f * Pi / 36.0f);
+
+	// A linha de 5 pixels vira triângulos (glLineWidth > 1 não existe no core profile): a
+	// largura em coordenadas normalizadas é 5 * 2 / WIDTH
+	Stroke::Style style;
+	style.width = 5.0f * 2.0f / WIDTH;
+	style.join = Stroke::JOIN_ROUND;
+	style.cap = Stroke::CAP_ROUND;
+	vector<GLfloat> triangles;
+	int nVertices = (int)Stroke::polyline(spiralPoints.data(), nSpiralPoints, 2, false, style, triangles);
+	GLuint VAO = Stroke::createVAO(triangles);
 
 	// Enviando a cor desejada (vec4) para o fragment shader
 	// Utilizamos a variáveis do tipo uniform em GLSL para armazenar esse tipo de info
@@ -128,9 +144,6 @@ int main()
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); //cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT);
 
-		glLineWidth(5);
-		glPointSize(20);
-
 		glBindVertexArray(VAO); //Conectando ao buffer de geometria
 
 		glUniform4f(colorLoc, 0.0f, 0.0f, 1.0f, 1.0f); //enviando cor para variável uniform inputColor
@@ -142,8 +155,8 @@ int main()
 		// glUniform4f(colorLoc, 1.0f, 0.0f, 1.0f, 1.0f); //enviando cor para variável uniform inputColor
 
 		// Chamada de desenho - drawcall
-		// Contorno - GL_LINE_LOOP
-		 glDrawArrays(GL_LINE_STRIP, 0, nVertices);
+		// Espiral - linha larga já em triângulos
+		glDrawArrays(GL_TRIANGLES, 0, nVertices);
 
 		// glUniform4f(colorLoc, 0.0f, 1.0f, 1.0f, 1.0f); //enviando cor para variável uniform inputColor
 
@@ -179,45 +192,9 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 // A função retorna o identificador do programa de shader
 int setupShader()
 {
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success) {
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
+	// Submete o programa à biblioteca de shaders (compilação assíncrona e cache de binários)
+	// e espera até ele ficar pronto
+	return ShaderLibrary::get().submit("lista1ex7", vertexShaderSource, fragmentShaderSource).get();
 }
 
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a 
@@ -271,66 +248,5 @@ int setupGeometry()
 	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
 	glBindVertexArray(0); 
 
-	return VAO;
-}
-
-int createSpiral(int nPoints)
-{
-	vector <GLfloat> vertices;
-
-	//float angle = 0.0;
-	//float slice = 2 * Pi / (float)nPoints;
-
-	//Adicionar o ponto da origem (0.0, 0.0, 0.0) como sendo o centro do círculo
-	vertices.push_back(0.0); //Xc
-	vertices.push_back(0.0); //Yc
-	vertices.push_back(0.0); //Zc
-
-	float radius = 0.0f;
-
-	for (float angle = 0; angle <= 1080; angle +=10)
-	{
-		float x = cos(angle * Pi / 180) * radius;
-		float y = sin(angle * Pi / 180) * radius;
-		float z = 0.0;
-
-		vertices.push_back(x);
-		vertices.push_back(y);
-		vertices.push_back(z);
-
-		radius += 0.005;
-	}
-
-	//Configuração dos buffers VBO e VAO
-	GLuint VBO, VAO;
-	//Geração do identificador do VBO
-	glGenBuffers(1, &VBO);
-	//Faz a conexão (vincula) do buffer como um buffer de array
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	//Envia os dados do array de floats para o buffer da OpenGl
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
-
-	//Geração do identificador do VAO (Vertex Array Object)
-	glGenVertexArrays(1, &VAO);
-	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-	// e os ponteiros para os atributos 
-	glBindVertexArray(VAO);
-	//Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando: 
-	// Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-	// Numero de valores que o atributo tem (por ex, 3 coordenadas xyz) 
-	// Tipo do dado
-	// Se está normalizado (entre zero e um)
-	// Tamanho em bytes 
-	// Deslocamento a partir do byte zero 
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
-	glEnableVertexAttribArray(0);
-
-	// Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice 
-	// atualmente vinculado - para que depois possamos desvincular com segurança
-	glBindBuffer(GL_ARRAY_BUFFER, 0); 
-
-	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0); 
-
 	return VAO;
 }
\ No newline at end of file
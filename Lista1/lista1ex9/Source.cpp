@@ -19,6 +19,12 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
+// Biblioteca de shaders (Common/include)
+#include "ShaderLibrary.h"
+
+// Lote de trechos do VAO (Common/include)
+#include "DrawBatch.h"
+
 
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
@@ -26,6 +32,7 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 // Protótipos das funções
 int setupShader();
 int setupGeometry();
+void setupBatch(DrawBatch& batch, GLuint VAO);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 600, HEIGHT = 600;
@@ -33,19 +40,22 @@ const GLuint WIDTH = 600, HEIGHT = 600;
 // Código fonte do Vertex Shader (em GLSL): ainda hardcoded
 const GLchar* vertexShaderSource = "#version 400\n"
 "layout (location = 0) in vec3 position;\n"
+"layout (location = 2) in vec4 vertexColor;\n"
+"out vec4 tint;\n"
 "void main()\n"
 "{\n"
 //...pode ter mais linhas de código aqui!
 "gl_Position = vec4(position.x, position.y, position.z, 1.0);\n"
+"tint = vertexColor;\n"
 "}\0";
 
 //Códifo fonte do Fragment Shader (em GLSL): ainda hardcoded
 const GLchar* fragmentShaderSource = "#version 400\n"
-"uniform vec4 inputColor;\n"
+"in vec4 tint;\n"
 "out vec4 color;\n"
 "void main()\n"
 "{\n"
-"color = inputColor;\n"
+"color = tint;\n"
 "}\n\0";
 
 // Função MAIN
@@ -100,10 +110,10 @@ int main()
 	GLuint VAO = setupGeometry();
 	
 
-	// Enviando a cor desejada (vec4) para o fragment shader
-	// Utilizamos a variáveis do tipo uniform em GLSL para armazenar esse tipo de info
-	// que não está nos buffers
-	GLint colorLoc = glGetUniformLocation(shaderID, "inputColor");
+	// As cores de cada parte do desenho vão num atributo de vértice (em vez do uniform
+	// inputColor), então as partes com o mesmo modo de desenho saem num só draw call
+	DrawBatch batch;
+	setupBatch(batch, VAO);
 	
 	glUseProgram(shaderID);
 	
@@ -121,36 +131,9 @@ int main()
 		glLineWidth(10);
 		glPointSize(20);
 
-		glBindVertexArray(VAO); //Conectando ao buffer de geometria
-
-		glUniform4f(colorLoc, 1.0f, 0.7f, 0.0f, 1.0f); //enviando cor para variável uniform inputColor
-
-		// Chamada de desenho - drawcall
-		// Poligono Preenchido - GL_TRIANGLE_FAN
-		glDrawArrays(GL_TRIANGLE_FAN, 0, 5);
-		glDrawArrays(GL_TRIANGLE_FAN, 4, 5);
-
-		glUniform4f(colorLoc, 1.0f, 0.0f, 0.0f, 1.0f);
-
-		glDrawArrays(GL_TRIANGLE_FAN, 9, 3);
-
-		glUniform4f(colorLoc, 0.0f, 0.0f, 0.0f, 1.0f);
-
-		// Chamada de desenho - drawcall
-		// Contorno - GL_LINE_LOOP
-		glDrawArrays(GL_LINE_STRIP, 12, 5);
-
-		glUniform4f(colorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
-
-		glDrawArrays(GL_TRIANGLE_FAN, 17, 4);
-		glDrawArrays(GL_TRIANGLE_FAN, 21, 4);
-
-		glUniform4f(colorLoc, 0.0f, 0.0f, 0.0f, 1.0f);
-
-		glDrawArrays(GL_TRIANGLE_FAN, 25, 4);
-		glDrawArrays(GL_TRIANGLE_FAN, 29, 4);
-
-		glBindVertexArray(0); //Desconectando o buffer de geometria
+		// Chamadas de desenho: poligonos preenchidos (GL_TRIANGLE_FAN) e a boca (GL_LINE_STRIP)
+		// 3 glMultiDrawArrays no lugar de 9 glDrawArrays e 5 trocas de cor
+		batch.draw();
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
@@ -178,45 +161,29 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 // A função retorna o identificador do programa de shader
 int setupShader()
 {
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success) {
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
+	// Submete o programa à biblioteca de shaders (compilação assíncrona e cache de binários)
+	// e espera até ele ficar pronto
+	return ShaderLibrary::get().submit("lista1ex9", vertexShaderSource, fragmentShaderSource).get();
+}
 
-	return shaderProgram;
+// Partes do desenho: trecho do VAO, modo de desenho e cor, na ordem em que são desenhadas
+void setupBatch(DrawBatch& batch, GLuint VAO)
+{
+	batch.init(VAO, 33);
+
+	// Cabeça
+	batch.add(GL_TRIANGLE_FAN, 0, 5, glm::vec3(1.0f, 0.7f, 0.0f));
+	batch.add(GL_TRIANGLE_FAN, 4, 5, glm::vec3(1.0f, 0.7f, 0.0f));
+	// Nariz
+	batch.add(GL_TRIANGLE_FAN, 9, 3, glm::vec3(1.0f, 0.0f, 0.0f));
+	// Boca (contorno)
+	batch.add(GL_LINE_STRIP, 12, 5, glm::vec3(0.0f, 0.0f, 0.0f));
+	// Olhos
+	batch.add(GL_TRIANGLE_FAN, 17, 4, glm::vec3(1.0f, 1.0f, 1.0f));
+	batch.add(GL_TRIANGLE_FAN, 21, 4, glm::vec3(1.0f, 1.0f, 1.0f));
+	// Íris
+	batch.add(GL_TRIANGLE_FAN, 25, 4, glm::vec3(0.0f, 0.0f, 0.0f));
+	batch.add(GL_TRIANGLE_FAN, 29, 4, glm::vec3(0.0f, 0.0f, 0.0f));
 }
 
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a 
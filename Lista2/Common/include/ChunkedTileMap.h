@@ -0,0 +1,305 @@
+// Tilemap de mundo grande dividido em chunks, com culling pela câmera e cache de VBOs
+// O mapa é cortado em chunks de CHUNK_SIZE x CHUNK_SIZE tiles. A geometria de cada chunk
+// (um quad por tile, com a cor da paleta já gravada nos vértices) é montada uma vez num VBO
+// próprio e reaproveitada enquanto o chunk não muda. A cada frame só os chunks que cruzam o
+// retângulo visível são desenhados, um glDrawElements por chunk.
+// setTile só aumenta a versão do chunk do tile: no próximo desenho apenas esse chunk é
+// remontado. Trocar uma cor da paleta invalida todos (a cor está nos vértices).
+// Os VBOs ficam num cache LRU limitado a maxResidentChunks: chunks que saem da tela
+// continuam na GPU até o limite e, passado dele, os usados há mais tempo são apagados (nunca
+// um chunk desenhado no frame atual; se os visíveis não cabem, o limite é excedido no frame).
+// stats() diz quantos chunks foram desenhados e remontados no último frame e quanta memória
+// o cache ocupa.
+// Vértice de 12 bytes: x, y em float (atributo 0) e cor RGBA em 4 bytes normalizados
+// (atributo 2, o vertexColor da variante VERTEX_COLOR do shader de sprite). Os índices de 16
+// bits (0 1 2, 1 3 2 por quad) são os mesmos para todos os chunks, num buffer compartilhado.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
+
+//GLAD
+#include <glad/glad.h>
+
+//GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+class ChunkedTileMap
+{
+public:
+	static const int CHUNK_SIZE = 32; // tiles por lado de um chunk (4096 vértices, cabe em 16 bits)
+	static const int PALETTE_SIZE = 256;
+
+	struct Stats
+	{
+		int visibleChunks = 0;    // chunks desenhados no último frame
+		int rebuilds = 0;         // chunks montados ou remontados no último frame
+		int evictions = 0;        // chunks tirados do cache no último frame
+		size_t residentChunks = 0;
+		size_t residentBytes = 0; // bytes de vértices nos VBOs do cache
+	};
+
+	// Mundo de columns x rows tiles de tileSize, com o canto inferior esquerdo em origin.
+	// Todos os tiles começam com o índice 0
+	bool init(int columns, int rows, glm::vec2 tileSize, glm::vec2 origin = glm::vec2(0.0f), size_t maxResidentChunks = 256)
+	{
+		if (columns <= 0 || rows <= 0)
+		{
+			std::cout << "ERROR::CHUNKEDTILEMAP::INVALID_SIZE " << columns << "x" << rows << std::endl;
+			return false;
+		}
+		nColumns = columns;
+		nRows = rows;
+		this->tileSize = tileSize;
+		this->origin = origin;
+		maxResident = std::max(maxResidentChunks, (size_t)1);
+		chunksX = (columns + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		chunksY = (rows + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		tiles.assign((size_t)columns * rows, 0);
+		chunkVersions.assign((size_t)chunksX * chunksY, 0);
+		colors.assign(PALETTE_SIZE, glm::packUnorm4x8(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+
+		// Índices de um chunk cheio, compartilhados por todos
+		std::vector<GLushort> indices;
+		indices.reserve(6 * CHUNK_SIZE * CHUNK_SIZE);
+		for (int q = 0; q < CHUNK_SIZE * CHUNK_SIZE; q++)
+		{
+			GLushort v = (GLushort)(4 * q);
+			GLushort quad[] = { v, (GLushort)(v + 1), (GLushort)(v + 2), (GLushort)(v + 1), (GLushort)(v + 3), (GLushort)(v + 2) };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+		glGenBuffers(1, &indexBuffer);
+		// GL_COPY_WRITE_BUFFER: não mexe no buffer de índices do VAO ligado agora
+		glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		return true;
+	}
+
+	void setPaletteColor(int index, glm::vec4 color)
+	{
+		GLuint packed = glm::packUnorm4x8(color);
+		if (colors[index] != packed)
+		{
+			colors[index] = packed;
+			paletteVersion++;
+		}
+	}
+
+	void setPaletteColor(int index, glm::vec3 color)
+	{
+		setPaletteColor(index, glm::vec4(color, 1.0f));
+	}
+
+	uint8_t tile(int column, int row) const
+	{
+		return tiles[(size_t)row * nColumns + column];
+	}
+
+	// Troca o índice de um tile; só o chunk dele é remontado, e só se o valor mudou
+	void setTile(int column, int row, uint8_t index)
+	{
+		uint8_t& t = tiles[(size_t)row * nColumns + column];
+		if (t != index)
+		{
+			t = index;
+			chunkVersions[(size_t)(row / CHUNK_SIZE) * chunksX + column / CHUNK_SIZE]++;
+		}
+	}
+
+	// Preenche todos os tiles com indexOf(column, row)
+	template <class IndexFn>
+	void fill(IndexFn indexOf)
+	{
+		for (int row = 0; row < nRows; row++)
+		{
+			uint8_t* line = tiles.data() + (size_t)row * nColumns;
+			for (int column = 0; column < nColumns; column++)
+			{
+				line[column] = (uint8_t)indexOf(column, row);
+			}
+		}
+		for (uint32_t& version : chunkVersions)
+		{
+			version++;
+		}
+	}
+
+	// Desenha os chunks que cruzam o retângulo [viewMin, viewMax] (coordenadas de mundo).
+	// O shader (sprite com VERTEX_COLOR, model identidade) precisa estar em uso
+	void draw(glm::vec2 viewMin, glm::vec2 viewMax)
+	{
+		frame++;
+		current = Stats();
+
+		// Chunks visíveis: intervalo [x0, x1] x [y0, y1], limitado ao mapa
+		glm::vec2 chunkSize = tileSize * (float)CHUNK_SIZE;
+		glm::vec2 first = glm::floor((viewMin - origin) / chunkSize);
+		glm::vec2 last = glm::floor((viewMax - origin) / chunkSize);
+		int x0 = std::max((int)first.x, 0), y0 = std::max((int)first.y, 0);
+		int x1 = std::min((int)last.x, chunksX - 1), y1 = std::min((int)last.y, chunksY - 1);
+
+		for (int cy = y0; cy <= y1; cy++)
+		{
+			for (int cx = x0; cx <= x1; cx++)
+			{
+				Entry& entry = acquire(cy * chunksX + cx);
+				glBindVertexArray(entry.VAO);
+				glDrawElements(GL_TRIANGLES, entry.indexCount, GL_UNSIGNED_SHORT, (GLvoid*)0);
+				current.visibleChunks++;
+			}
+		}
+		glBindVertexArray(0);
+
+		evict();
+		current.residentChunks = cache.size();
+		current.residentBytes = residentBytes;
+	}
+
+	int columns() const { return nColumns; }
+	int rows() const { return nRows; }
+
+	// Números do último draw
+	const Stats& stats() const { return current; }
+
+private:
+	struct ChunkVertex
+	{
+		GLfloat x, y;
+		GLuint color; // RGBA8 (glm::packUnorm4x8)
+	};
+
+	struct Entry
+	{
+		GLuint VAO = 0, VBO = 0;
+		GLsizei indexCount = 0;
+		size_t bytes = 0;
+		uint32_t version = 0, paletteVersion = 0;
+		bool built = false;
+		uint64_t lastFrame = 0;
+		std::list<int>::iterator lruPosition;
+	};
+
+	int nColumns = 0, nRows = 0;
+	int chunksX = 0, chunksY = 0;
+	glm::vec2 tileSize = glm::vec2(1.0f), origin = glm::vec2(0.0f);
+	std::vector<uint8_t> tiles;
+	std::vector<GLuint> colors;
+	std::vector<uint32_t> chunkVersions;
+	uint32_t paletteVersion = 0;
+	GLuint indexBuffer = 0;
+
+	// Cache: chunk -> VBO; lru tem os chunks do usado mais recentemente para o mais antigo
+	std::unordered_map<int, Entry> cache;
+	std::list<int> lru;
+	size_t maxResident = 256;
+	size_t residentBytes = 0;
+	uint64_t frame = 0;
+	Stats current;
+	std::vector<ChunkVertex> vertices; // reaproveitado entre montagens
+
+	// Entrada do chunk no cache, criada ou remontada se preciso, e marcada como a mais recente
+	Entry& acquire(int chunk)
+	{
+		auto found = cache.find(chunk);
+		if (found == cache.end())
+		{
+			Entry entry;
+			glGenBuffers(1, &entry.VBO);
+			glGenVertexArrays(1, &entry.VAO);
+			glBindVertexArray(entry.VAO);
+			glBindBuffer(GL_ARRAY_BUFFER, entry.VBO);
+			glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(ChunkVertex), (GLvoid*)0);
+			glEnableVertexAttribArray(0);
+			glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ChunkVertex), (GLvoid*)(2 * sizeof(GLfloat)));
+			glEnableVertexAttribArray(2);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+			glBindVertexArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			lru.push_front(chunk);
+			entry.lruPosition = lru.begin();
+			found = cache.emplace(chunk, entry).first;
+		}
+		else
+		{
+			lru.splice(lru.begin(), lru, found->second.lruPosition);
+		}
+
+		Entry& entry = found->second;
+		entry.lastFrame = frame;
+		if (!entry.built || entry.version != chunkVersions[chunk] || entry.paletteVersion != paletteVersion)
+		{
+			build(chunk, entry);
+		}
+		return entry;
+	}
+
+	// Grava no VBO do chunk um quad por tile, com a cor da paleta
+	void build(int chunk, Entry& entry)
+	{
+		int column0 = (chunk % chunksX) * CHUNK_SIZE, row0 = (chunk / chunksX) * CHUNK_SIZE;
+		int column1 = std::min(column0 + CHUNK_SIZE, nColumns), row1 = std::min(row0 + CHUNK_SIZE, nRows);
+
+		vertices.clear();
+		for (int row = row0; row < row1; row++)
+		{
+			const uint8_t* line = tiles.data() + (size_t)row * nColumns;
+			float yMin = origin.y + row * tileSize.y, yMax = yMin + tileSize.y;
+			for (int column = column0; column < column1; column++)
+			{
+				GLuint color = colors[line[column]];
+				float xMin = origin.x + column * tileSize.x, xMax = xMin + tileSize.x;
+				vertices.push_back(ChunkVertex{ xMin, yMax, color });
+				vertices.push_back(ChunkVertex{ xMin, yMin, color });
+				vertices.push_back(ChunkVertex{ xMax, yMax, color });
+				vertices.push_back(ChunkVertex{ xMax, yMin, color });
+			}
+		}
+
+		size_t bytes = vertices.size() * sizeof(ChunkVertex);
+		glBindBuffer(GL_ARRAY_BUFFER, entry.VBO);
+		glBufferData(GL_ARRAY_BUFFER, bytes, vertices.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		residentBytes += bytes - entry.bytes;
+		entry.bytes = bytes;
+		entry.indexCount = (GLsizei)(vertices.size() / 4 * 6);
+		entry.version = chunkVersions[chunk];
+		entry.paletteVersion = paletteVersion;
+		entry.built = true;
+		current.rebuilds++;
+	}
+
+	// Apaga os chunks usados há mais tempo até caber no limite (nunca um do frame atual)
+	void evict()
+	{
+		while (cache.size() > maxResident)
+		{
+			int chunk = lru.back();
+			auto found = cache.find(chunk);
+			if (found->second.lastFrame == frame)
+			{
+				break;
+			}
+			destroy(found->second);
+			lru.pop_back();
+			cache.erase(found);
+			current.evictions++;
+		}
+	}
+
+	void destroy(Entry& entry)
+	{
+		residentBytes -= entry.bytes;
+		glDeleteBuffers(1, &entry.VBO);
+		glDeleteVertexArrays(1, &entry.VAO);
+	}
+};
@@ -0,0 +1,256 @@
+// Variantes de shader geradas a partir de um único código fonte
+// O ShaderPreprocessor monta o código final de um shader resolvendo #include "nome"
+// (fontes de ShaderSources.h ou, se não estiverem lá, arquivos da pasta de busca); cada
+// arquivo entra uma vez só e recebe diretivas #line, para as mensagens de erro apontarem
+// a linha certa (o número do arquivo é a ordem em que ele foi incluído, começando em 0).
+// O ShaderVariants guarda os programas de um par vertex/fragment por conjunto de features
+// (máscara de bits): cada variante é compilada só na primeira vez em que é pedida, com os
+// #defines correspondentes, e passa pela ShaderLibrary (compilação assíncrona e cache).
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+//GLAD
+#include <glad/glad.h>
+
+#include "ShaderLibrary.h"
+#include "ShaderSources.h"
+
+class ShaderPreprocessor
+{
+public:
+	// Instância única, já com as fontes de ShaderSources.h
+	static ShaderPreprocessor& get()
+	{
+		static ShaderPreprocessor preprocessor;
+		return preprocessor;
+	}
+
+	// Registra (ou substitui) uma fonte com esse nome
+	void addSource(const std::string& name, const std::string& code)
+	{
+		sources[name] = code;
+	}
+
+	// Pasta onde procurar os arquivos que não foram registrados
+	void setSearchPath(const std::string& directory)
+	{
+		searchPath = directory;
+	}
+
+	// Monta o código final do shader com esse nome. Retorna "" em caso de erro
+	std::string process(const std::string& name)
+	{
+		std::string out;
+		std::vector<std::string> stack, files;
+		if (!expand(name, out, stack, files))
+		{
+			return "";
+		}
+		return out;
+	}
+
+private:
+	std::unordered_map<std::string, std::string> sources;
+	std::string searchPath = "shaders";
+
+	ShaderPreprocessor()
+	{
+		for (const ShaderSources::Source& source : ShaderSources::ALL)
+		{
+			sources[source.name] = source.code;
+		}
+	}
+
+	bool find(const std::string& name, std::string& code) const
+	{
+		auto it = sources.find(name);
+		if (it != sources.end())
+		{
+			code = it->second;
+			return true;
+		}
+		std::ifstream file(searchPath + "/" + name);
+		if (!file)
+		{
+			return false;
+		}
+		std::stringstream stream;
+		stream << file.rdbuf();
+		code = stream.str();
+		return true;
+	}
+
+	static bool startsWith(const std::string& line, size_t first, const char* directive)
+	{
+		return line.compare(first, strlen(directive), directive) == 0;
+	}
+
+	bool expand(const std::string& name, std::string& out, std::vector<std::string>& stack, std::vector<std::string>& files)
+	{
+		if (std::find(stack.begin(), stack.end(), name) != stack.end())
+		{
+			std::cout << "ERROR::SHADER::INCLUDE_CYCLE " << name << std::endl;
+			return false;
+		}
+		if (std::find(files.begin(), files.end(), name) != files.end())
+		{
+			// Já incluído neste shader
+			return true;
+		}
+		std::string code;
+		if (!find(name, code))
+		{
+			std::cout << "ERROR::SHADER::INCLUDE_NOT_FOUND " << name << std::endl;
+			return false;
+		}
+
+		int fileIndex = (int)files.size();
+		files.push_back(name);
+		stack.push_back(name);
+		if (fileIndex > 0)
+		{
+			out += "#line 1 " + std::to_string(fileIndex) + "\n";
+		}
+
+		std::istringstream in(code);
+		std::string line;
+		int lineNumber = 0;
+		while (std::getline(in, line))
+		{
+			lineNumber++;
+			size_t first = line.find_first_not_of(" \t");
+			if (first != std::string::npos && startsWith(line, first, "#include"))
+			{
+				size_t open = line.find('"', first);
+				size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+				if (close == std::string::npos)
+				{
+					std::cout << "ERROR::SHADER::INCLUDE_SYNTAX " << name << ":" << lineNumber << ": " << line << std::endl;
+					return false;
+				}
+				if (!expand(line.substr(open + 1, close - open - 1), out, stack, files))
+				{
+					return false;
+				}
+				out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+				continue;
+			}
+
+			out += line + "\n";
+			if (first != std::string::npos && startsWith(line, first, "#version"))
+			{
+				// Os #defines das variantes entram logo depois do #version: a numeração
+				// volta ao normal a partir daqui
+				out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+			}
+		}
+
+		stack.pop_back();
+		return true;
+	}
+};
+
+class ShaderVariants
+{
+public:
+	// Features de uma variante (combinar com |)
+	enum Feature : unsigned
+	{
+		TEXTURED = 1 << 0,     // cor vem da textura texBuff (atributo 1 = coordenadas de textura)
+		ANIMATED = 1 << 1,     // deslocamento offsetTex nas coordenadas de textura (spritesheet)
+		INSTANCED = 1 << 2,    // deslocamento e cor por instância (atributos 3 e 4)
+		VERTEX_COLOR = 1 << 3, // cor por vértice (atributo 2)
+	};
+
+	ShaderVariants(const std::string& vertexName, const std::string& fragmentName)
+		: vertexName(vertexName), fragmentName(fragmentName) {}
+
+	// Pede a variante: submete na primeira vez, depois devolve a mesma
+	ShaderFuture request(unsigned features)
+	{
+		features = normalize(features);
+		auto it = variants.find(features);
+		if (it != variants.end())
+		{
+			return it->second;
+		}
+
+		ShaderFuture future;
+		std::string vs = ShaderPreprocessor::get().process(vertexName);
+		std::string fs = ShaderPreprocessor::get().process(fragmentName);
+		if (!vs.empty() && !fs.empty())
+		{
+			future = ShaderLibrary::get().submit(nameFor(features), vs, fs, definesFor(features));
+		}
+		else
+		{
+			std::cout << "ERROR::SHADER::VARIANT_NOT_BUILT " << nameFor(features) << std::endl;
+		}
+		variants[features] = future;
+		return future;
+	}
+
+	// Pede a variante e espera o programa ficar pronto
+	GLuint get(unsigned features)
+	{
+		return request(features).get();
+	}
+
+	// Quantas variantes já foram pedidas
+	int size() const
+	{
+		return (int)variants.size();
+	}
+
+	static std::string definesFor(unsigned features)
+	{
+		std::string defines;
+		for (int i = 0; i < N_FEATURES; i++)
+		{
+			if (features & (1u << i))
+			{
+				defines += std::string("#define ") + FEATURE_NAMES[i] + "\n";
+			}
+		}
+		return defines;
+	}
+
+	std::string nameFor(unsigned features) const
+	{
+		std::string name = vertexName + "+" + fragmentName + "[";
+		for (int i = 0; i < N_FEATURES; i++)
+		{
+			if (features & (1u << i))
+			{
+				name += (name.back() == '[' ? "" : "|") + std::string(FEATURE_NAMES[i]);
+			}
+		}
+		return name + "]";
+	}
+
+private:
+	static const int N_FEATURES = 4;
+	static constexpr const char* FEATURE_NAMES[N_FEATURES] = { "TEXTURED", "ANIMATED", "INSTANCED", "VERTEX_COLOR" };
+
+	std::string vertexName, fragmentName;
+	std::unordered_map<unsigned, ShaderFuture> variants;
+
+	// ANIMATED só tem efeito com TEXTURED: evita compilar duas variantes iguais
+	static unsigned normalize(unsigned features)
+	{
+		if (!(features & TEXTURED))
+		{
+			features &= ~(unsigned)ANIMATED;
+		}
+		return features;
+	}
+};
@@ -0,0 +1,228 @@
+// Tilemap desenhado em uma única draw call
+// Cada tile é um índice de 8 bits na paleta (até PALETTE_SIZE cores). Os índices ficam numa
+// textura de inteiros (GL_R8UI, um texel por tile, linha 0 embaixo) e a paleta numa textura
+// PALETTE_SIZE x 1; um quad cobre o mapa inteiro e o fragment shader (tilemap.fs, em
+// ShaderSources.h) busca o índice do tile sob o pixel e a cor dele. O custo do desenho é por
+// pixel da tela, não por tile: um mapa de 4096 x 4096 tiles custa o mesmo que um de 8 x 6 e
+// ocupa 16 MB de textura.
+// Os índices também ficam na CPU. setTile só marca o retângulo alterado e upload() (chamado
+// pelo draw) envia apenas esse retângulo com glTexSubImage2D; sem mudanças, nada é enviado.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+//GLAD
+#include <glad/glad.h>
+
+//GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader.h"
+
+class TileMap
+{
+public:
+	static const int PALETTE_SIZE = 256;
+
+	// Mapa de columns x rows tiles de tileSize pixels, com o canto inferior esquerdo em
+	// origin. Todos os tiles começam com o índice 0. Retorna false se a textura não cabe
+	bool init(int columns, int rows, glm::vec2 tileSize, glm::vec2 origin = glm::vec2(0.0f))
+	{
+		GLint maxSize = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+		if (columns <= 0 || rows <= 0 || columns > maxSize || rows > maxSize)
+		{
+			std::cout << "ERROR::TILEMAP::TOO_LARGE " << columns << "x" << rows << " (maximo " << maxSize << ")" << std::endl;
+			return false;
+		}
+		nColumns = columns;
+		nRows = rows;
+		this->tileSize = tileSize;
+		this->origin = origin;
+		tiles.assign((size_t)columns * rows, 0);
+		colors.assign(PALETTE_SIZE, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+		glGenTextures(1, &tilesTexture);
+		glBindTexture(GL_TEXTURE_2D, tilesTexture);
+		setNearest();
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, columns, rows, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, NULL);
+
+		glGenTextures(1, &paletteTexture);
+		glBindTexture(GL_TEXTURE_2D, paletteTexture);
+		setNearest();
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, PALETTE_SIZE, 1, 0, GL_RGBA, GL_FLOAT, NULL);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// Quad de (0, 0) a (1, 1); a matriz de modelo leva para o tamanho do mapa
+		GLfloat quad[] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f };
+		GLuint VBO;
+		glGenBuffers(1, &VBO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid*)0);
+		glEnableVertexAttribArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+
+		markAll();
+		paletteDirty = true;
+		return true;
+	}
+
+	void setPaletteColor(int index, glm::vec4 color)
+	{
+		if (colors[index] != color)
+		{
+			colors[index] = color;
+			paletteDirty = true;
+		}
+	}
+
+	void setPaletteColor(int index, glm::vec3 color)
+	{
+		setPaletteColor(index, glm::vec4(color, 1.0f));
+	}
+
+	uint8_t tile(int column, int row) const
+	{
+		return tiles[(size_t)row * nColumns + column];
+	}
+
+	// Troca o índice de um tile (só marca para envio se mudou)
+	void setTile(int column, int row, uint8_t index)
+	{
+		uint8_t& t = tiles[(size_t)row * nColumns + column];
+		if (t == index)
+		{
+			return;
+		}
+		t = index;
+		if (dirtyMax.x < dirtyMin.x)
+		{
+			dirtyMin = dirtyMax = glm::ivec2(column, row);
+		}
+		else
+		{
+			dirtyMin = glm::min(dirtyMin, glm::ivec2(column, row));
+			dirtyMax = glm::max(dirtyMax, glm::ivec2(column, row));
+		}
+	}
+
+	// Preenche todos os tiles com indexOf(column, row)
+	template <class IndexFn>
+	void fill(IndexFn indexOf)
+	{
+		for (int row = 0; row < nRows; row++)
+		{
+			uint8_t* line = tiles.data() + (size_t)row * nColumns;
+			for (int column = 0; column < nColumns; column++)
+			{
+				line[column] = (uint8_t)indexOf(column, row);
+			}
+		}
+		markAll();
+	}
+
+	// Envia o que mudou desde o último envio. Retorna os bytes enviados
+	size_t upload()
+	{
+		size_t bytes = 0;
+		if (dirtyMax.x >= dirtyMin.x)
+		{
+			int width = dirtyMax.x - dirtyMin.x + 1, height = dirtyMax.y - dirtyMin.y + 1;
+			glBindTexture(GL_TEXTURE_2D, tilesTexture);
+			// Linhas de 1 byte por tile, sem alinhamento; o retângulo é lido direto do array
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, nColumns);
+			glPixelStorei(GL_UNPACK_SKIP_PIXELS, dirtyMin.x);
+			glPixelStorei(GL_UNPACK_SKIP_ROWS, dirtyMin.y);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, dirtyMin.x, dirtyMin.y, width, height, GL_RED_INTEGER, GL_UNSIGNED_BYTE, tiles.data());
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+			glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+			glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+			bytes += (size_t)width * height;
+			dirtyMin = glm::ivec2(1);
+			dirtyMax = glm::ivec2(0);
+		}
+		if (paletteDirty)
+		{
+			glBindTexture(GL_TEXTURE_2D, paletteTexture);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, PALETTE_SIZE, 1, GL_RGBA, GL_FLOAT, colors.data());
+			bytes += PALETTE_SIZE * sizeof(glm::vec4);
+			paletteDirty = false;
+		}
+		glBindTexture(GL_TEXTURE_2D, 0);
+		uploaded = bytes;
+		return bytes;
+	}
+
+	// Desenha o mapa inteiro com o shader de tilemap (tilemap.vs / tilemap.fs), que precisa
+	// estar em uso. Usa as unidades de textura 0 (tiles) e 1 (paleta)
+	void draw(Shader& shader)
+	{
+		upload();
+
+		glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(origin, 0.0f));
+		model = glm::scale(model, glm::vec3(tileSize.x * nColumns, tileSize.y * nRows, 1.0f));
+		shader.setMat4("model", glm::value_ptr(model));
+		shader.setVec2("mapSize", (float)nColumns, (float)nRows);
+		shader.setInt("tiles", 0);
+		shader.setInt("palette", 1);
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, tilesTexture);
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, paletteTexture);
+
+		glBindVertexArray(VAO);
+		glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+		glBindVertexArray(0);
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	int columns() const { return nColumns; }
+	int rows() const { return nRows; }
+
+	// Bytes enviados para a GPU no último upload
+	size_t lastUploadBytes() const { return uploaded; }
+
+private:
+	int nColumns = 0, nRows = 0;
+	glm::vec2 tileSize = glm::vec2(1.0f), origin = glm::vec2(0.0f);
+	std::vector<uint8_t> tiles;
+	std::vector<glm::vec4> colors;
+	GLuint tilesTexture = 0, paletteTexture = 0, VAO = 0;
+
+	// Retângulo de tiles alterados (vazio quando dirtyMax < dirtyMin)
+	glm::ivec2 dirtyMin = glm::ivec2(1), dirtyMax = glm::ivec2(0);
+	bool paletteDirty = false;
+	size_t uploaded = 0;
+
+	void markAll()
+	{
+		dirtyMin = glm::ivec2(0);
+		dirtyMax = glm::ivec2(nColumns - 1, nRows - 1);
+	}
+
+	static void setNearest()
+	{
+		// Texturas de inteiros não podem ser filtradas: sem interpolação e sem mipmaps
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+};
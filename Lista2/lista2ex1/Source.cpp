@@ -19,11 +19,24 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
+// Biblioteca de shaders e variantes por features (Common/include)
+#include "ShaderLibrary.h"
+#include "ShaderVariants.h"
+
 //GLM
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Uniform buffer com câmera e dados do frame (Common/include)
+#include "FrameUniforms.h"
+
+// Envio de uniforms sem repetir valores (Common/include)
+#include "Shader.h"
+
+// Linhas largas e pontos em triângulos (Common/include)
+#include "Stroke.h"
+
 #include <cmath>
 
 using namespace glm;
@@ -35,28 +48,27 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 // Protótipos das funções
 int setupShader();
 int setupGeometry();
+int setupOutline(int& nOutlineVertices, int& nPointVertices);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
 
-// Código fonte do Vertex Shader (em GLSL): ainda hardcoded
-const GLchar* vertexShaderSource = "#version 400\n"
-"uniform mat4 projection;\n"
-"layout (location = 0) in vec3 position;\n"
-"void main()\n"
-"{\n"
-//...pode ter mais linhas de código aqui!
-"gl_Position = projection * vec4(position.x, position.y, position.z, 1.0);\n"
-"}\0";
-
-//Códifo fonte do Fragment Shader (em GLSL): ainda hardcoded
-const GLchar* fragmentShaderSource = "#version 400\n"
-"uniform vec4 inputColor;\n"
-"out vec4 color;\n"
-"void main()\n"
-"{\n"
-"color = inputColor;\n"
-"}\n\0";
+// Coordenadas x, y e z dos dois triângulos, usadas pela geometria (setupGeometry) e pelos
+// contornos e pontos (setupOutline)
+const GLfloat vertices[] = {
+	//x   y     z
+	//T0
+	 100, 100, 0.0, //v0
+	 500, 100, 0.0, //v1
+	 300, 500, 0.0, //v2
+	//T1
+	500,  300, 0.0, //v3
+	700,  300, 0.0, //v4
+	600,  500, 0.0 //v5
+};
+
+// Shaders de sprite: código fonte único em Common/include/ShaderSources.h
+ShaderVariants spriteShaders("sprite.vs", "sprite.fs");
 
 // Função MAIN
 int main()
@@ -108,19 +120,35 @@ int main()
 
 	// Gerando um buffer simples, com a geometria de um triângulo
 	GLuint VAO = setupGeometry();
+
+	// Contornos e pontos dos mesmos vértices, já em triângulos
+	int nOutlineVertices, nPointVertices;
+	GLuint outlineVAO = setupOutline(nOutlineVertices, nPointVertices);
 	
 
 	// Enviando a cor desejada (vec4) para o fragment shader
 	// Utilizamos a variáveis do tipo uniform em GLSL para armazenar esse tipo de info
 	// que não está nos buffers
-	GLint colorLoc = glGetUniformLocation(shaderID, "inputColor");
+	// O Shader guarda o último valor de cada uniform e só envia o que mudou
+	Shader shader(shaderID);
 	
-	glUseProgram(shaderID);
+	shader.Use();
 	
+	// Câmera e dados do frame ficam num uniform buffer compartilhado por todos os shaders
+	FrameUniforms frame;
+	frame.init();
+	ShaderLibrary::get().bindUniformBlock("FrameData", FRAME_DATA_BINDING);
+
 	// Matriz de projeção paralela ortográfica
-	mat4 projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);
-	GLint projLoc = glGetUniformLocation(shaderID, "projection");
-	glUniformMatrix4fv(projLoc, 1, GL_FALSE, value_ptr(projection));
+	frame.data.projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);
+	frame.data.viewport = vec2(width, height);
+
+	// O shader de sprite sempre aplica a matriz de modelo: aqui ela é a identidade
+	shader.setMat4("model", value_ptr(mat4(1)));
+
+	// Uniforms enviados / evitados, somados e mostrados uma vez por segundo
+	Shader::UniformStats uniformsSinceReport;
+	double uniformReportTime = glfwGetTime();
 
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
@@ -128,42 +156,57 @@ int main()
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
 
+		// Atualiza o bloco FrameData uma única vez por frame
+		frame.data.time = glfwGetTime();
+		frame.update();
+
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); //cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT);
 
-		glLineWidth(10);
-		glPointSize(20);
-
 		glBindVertexArray(VAO); //Conectando ao buffer de geometria
 
-		glUniform4f(colorLoc, 0.0f, 0.0f, 1.0f, 1.0f); //enviando cor para variável uniform inputColor
+		shader.setVec4("inputColor", 0.0f, 0.0f, 1.0f, 1.0f); //enviando cor para variável uniform inputColor
 
 		// Chamada de desenho - drawcall
 		// Poligono Preenchido - GL_TRIANGLES
 		glDrawArrays(GL_TRIANGLES, 0, 6);
 
-		glUniform4f(colorLoc, 1.0f, 0.0f, 0.0f, 1.0f);
+		glBindVertexArray(outlineVAO);
+
+		shader.setVec4("inputColor", 1.0f, 0.0f, 0.0f, 1.0f);
 
 		// Chamada de desenho - drawcall
-		// Contorno - GL_LINE_LOOP
-		glDrawArrays(GL_LINE_LOOP, 0, 3);
-		glDrawArrays(GL_LINE_LOOP, 3, 3);
+		// Contorno - os dois laços de 10 pixels de largura
+		glDrawArrays(GL_TRIANGLES, 0, nOutlineVertices);
 
-		glUniform4f(colorLoc, 0.0f, 1.0f, 0.0f, 1.0f);
+		shader.setVec4("inputColor", 0.0f, 1.0f, 0.0f, 1.0f);
 
 		// Chamada de desenho - drawcall
-		// Pontos - GL_POINTS
-		glDrawArrays(GL_POINTS, 0, 6);
+		// Pontos - quadrados de 20 pixels
+		glDrawArrays(GL_TRIANGLES, nOutlineVertices, nPointVertices);
 
 
 		glBindVertexArray(0); //Desconectando o buffer de geometria
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
+
+		// Contadores de uniforms enviados / evitados neste frame
+		Shader::UniformStats uniforms = Shader::endFrame();
+		uniformsSinceReport.sent += uniforms.sent;
+		uniformsSinceReport.skipped += uniforms.skipped;
+		if (glfwGetTime() - uniformReportTime >= 1.0)
+		{
+			cout << "Uniforms no ultimo segundo: " << uniformsSinceReport.sent << " enviados, "
+				<< uniformsSinceReport.skipped << " evitados" << endl;
+			uniformsSinceReport = Shader::UniformStats();
+			uniformReportTime = glfwGetTime();
+		}
 	}
 	// Pede pra OpenGL desalocar os buffers
 	glDeleteVertexArrays(1, &VAO);
+	glDeleteVertexArrays(1, &outlineVAO);
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
 	return 0;
@@ -178,52 +221,12 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 		glfwSetWindowShouldClose(window, GL_TRUE);
 }
 
-//Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
-// shader simples e único neste exemplo de código
-// O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-// fragmentShader source no iniçio deste arquivo
-// A função retorna o identificador do programa de shader
+// Pede a variante básica do shader de sprite (cor sólida vinda do uniform inputColor)
+// O código fonte fica em Common/include/ShaderSources.h, compartilhado com os outros programas
+// A função espera o programa ficar pronto e retorna o seu identificador
 int setupShader()
 {
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success) {
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
+	return spriteShaders.get(0);
 }
 
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a 
@@ -233,21 +236,10 @@ int setupShader()
 // A função retorna o identificador do VAO
 int setupGeometry()
 {
-	// Aqui setamos as coordenadas x, y e z do triângulo e as armazenamos de forma
-	// sequencial, já visando mandar para o VBO (Vertex Buffer Objects)
+	// As coordenadas x, y e z dos triângulos (vertices, no início do arquivo) estão
+	// armazenadas de forma sequencial, já visando mandar para o VBO (Vertex Buffer Objects)
 	// Cada atributo do vértice (coordenada, cores, coordenadas de textura, normal, etc)
 	// Pode ser arazenado em um VBO único ou em VBOs separados
-	GLfloat vertices[] = {
-		//x   y     z
-		//T0
-		 100, 100, 0.0, //v0
-		 500, 100, 0.0, //v1
- 		 300, 500, 0.0, //v2
-		//T1
-		500,  300, 0.0, //v3
-		700,  300, 0.0, //v4
-		600,  500, 0.0 //v5
-	};
 
 	GLuint VBO, VAO;
 	//Geração do identificador do VBO
@@ -282,3 +274,20 @@ int setupGeometry()
 	return VAO;
 }
 
+
+// Contornos (GL_LINE_LOOP com glLineWidth(10)) e pontos (GL_POINTS com glPointSize(20)) dos
+// dois triângulos de setupGeometry, tesselados em triângulos: primeiro os dois contornos,
+// depois os seis pontos. A projeção é em pixels, então as larguras são as mesmas
+// A função retorna o identificador do VAO
+int setupOutline(int& nOutlineVertices, int& nPointVertices)
+{
+	// Os mesmos vértices da geometria: 3 floats por ponto (o z é ignorado)
+	Stroke::Style style;
+	style.width = 10.0f;
+	vector<GLfloat> triangles;
+	nOutlineVertices = (int)Stroke::polyline(vertices, 3, 3, true, style, triangles);
+	nOutlineVertices += (int)Stroke::polyline(vertices + 9, 3, 3, true, style, triangles);
+	nPointVertices = (int)Stroke::dots(vertices, 6, 3, 20.0f, triangles);
+
+	return Stroke::createVAO(triangles);
+}
@@ -19,51 +19,155 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
+// Biblioteca de shaders e variantes por features (Common/include)
+#include "ShaderLibrary.h"
+#include "ShaderVariants.h"
+
 //GLM
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Uniform buffer com câmera e dados do frame (Common/include)
+#include "FrameUniforms.h"
+
+// Envio de uniforms sem repetir valores (Common/include)
+#include "Shader.h"
+
+// Mapa de tiles desenhado numa draw call só (Common/include)
+#include "TileMap.h"
+
+// Mundo grande em chunks, com culling pela câmera e cache de VBOs (Common/include)
+#include "ChunkedTileMap.h"
+
+// Tabelas de cores e padrões geradas na compilação (Common/include)
+#include "Palette.h"
+
 #include <cmath>
+#include <cstdlib>
+#include <algorithm>
 
 using namespace glm;
 
 
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 
 // Protótipos das funções
 int setupShader();
-int setupGeometry();
-
-void drawSquares(GLuint shaderID);
+bool setupTileMap(int columns, int rows);
+int tileFor(int i, int j);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
 
-// Código fonte do Vertex Shader (em GLSL): ainda hardcoded
-const GLchar* vertexShaderSource = "#version 400\n"
-"uniform mat4 projection;\n"
-"uniform mat4 model;\n"
-"layout (location = 0) in vec3 position;\n"
-"void main()\n"
-"{\n"
-//...pode ter mais linhas de código aqui!
-"gl_Position = projection * model * vec4(position.x, position.y, position.z, 1.0);\n"
-"}\0";
-
-//Códifo fonte do Fragment Shader (em GLSL): ainda hardcoded
-const GLchar* fragmentShaderSource = "#version 400\n"
-"uniform vec4 inputColor;\n"
-"out vec4 color;\n"
-"void main()\n"
-"{\n"
-"color = inputColor;\n"
-"}\n\0";
+// Shaders de tilemap e de sprite: código fonte único em Common/include/ShaderSources.h
+ShaderVariants tilemapShaders("tilemap.vs", "tilemap.fs");
+ShaderVariants spriteShaders("sprite.vs", "sprite.fs");
+
+// Cores da paleta, na ordem dos casos de squareColor (a última é a cor padrão)
+constexpr Palette::Color COLORS[] = {
+	Palette::rgb(0.9f, 0.9f, 0.0f),
+	Palette::rgb(0.8f, 0.4f, 0.8f),
+	Palette::rgb(0.0f, 0.7f, 1.0f),
+	Palette::rgb(0.9f, 0.0f, 0.0f),
+	Palette::rgb(0.1f, 1.0f, 0.1f),
+	Palette::rgb(0.1f, 1.0f, 1.0f),
+	Palette::rgb(0.6f, 0.3f, 0.0f),
+	Palette::rgb(0.3f, 0.0f, 0.5f),
+	Palette::rgb(1.0f, 0.1f, 0.6f),
+	Palette::rgb(0.4f, 0.5f, 0.0f),
+	Palette::rgb(0.9f, 0.5f, 0.0f),
+	Palette::rgb(0.5f, 0.5f, 0.5f)
+};
+const int N_COLORS = sizeof(COLORS) / sizeof(COLORS[0]);
+
+// Índice na paleta do quadrado da linha i, coluna j; avaliada só na compilação, para gerar
+// SQUARE_PATTERN
+constexpr int squareColor(int i, int j)
+{
+	if (i % 4 == 0 && j % 4 == 0)
+	{
+		return 0;
+	}
+	else if (i % 3 == 2 && j % 3 == 1)
+	{
+		return 1;
+	}
+	else if (i % 2 == 0 && j % 6 == 0)
+	{
+		return 2;
+	}
+	else if (i % 5 == 2 && j % 3 == 2)
+	{
+		return 3;
+	}
+	else if (i % 2 == 0 && j % 4 == 3)
+	{
+		return 4;
+	}
+	else if (i % 2 == 1 && j % 4 == 3)
+	{
+		return 5;
+	}
+	else if (i % 3 == 1 && j % 3 == 2)
+	{
+		return 6;
+	}
+	else if (i % 3 == 0 && j % 2 == 0)
+	{
+		return 7;
+	}
+	else if (i % 2 == 1 && j % 2 == 1)
+	{
+		return 8;
+	}
+	else if (i % 2 == 1 && j % 2 == 0)
+	{
+		return 9;
+	}
+	else if (i % 2 == 0 && j % 2 == 1)
+	{
+		return 10;
+	}
+	else 
+	{
+		return 11;
+	}
+}
+
+// Tabela do padrão: i usa % 2, 3, 4 e 5 (repete a cada 60 linhas) e j usa % 2, 3, 4 e 6
+// (repete a cada 12 colunas)
+constexpr Palette::Pattern<uint8_t, 60, 12> SQUARE_PATTERN = Palette::generatePattern<uint8_t, 60, 12>(squareColor);
+static_assert(Palette::isPeriodic<60, 12>(squareColor), "SQUARE_PATTERN: periodo errado");
+
+// Grade de quadrados: 8 x 6 de 100 pixels, ou --size N para N x N tiles cobrindo a janela
+TileMap tileMap;
+float tileSize = 100.0f;
+
+// --world N: mundo de N x N tiles de 16 pixels em chunks, percorrido com as setas
+ChunkedTileMap worldMap;
+bool worldMode = false;
+vec2 camera = vec2(0.0f);
+const float CAMERA_SPEED = 600.0f; // pixels por segundo
 
 // Função MAIN
-int main()
+int main(int argc, char** argv)
 {
+	int columns = 8, rows = 6;
+	if (argc > 2 && string(argv[1]) == "--size")
+	{
+		columns = rows = std::max(atoi(argv[2]), 1);
+		tileSize = std::min((float)WIDTH / columns, (float)HEIGHT / rows);
+	}
+	else if (argc > 2 && string(argv[1]) == "--world")
+	{
+		columns = rows = std::max(atoi(argv[2]), 1);
+		tileSize = 16.0f;
+		worldMode = true;
+	}
+
 	// Inicialização da GLFW
 	glfwInit();
 
@@ -86,6 +190,7 @@ int main()
 
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
+	glfwSetMouseButtonCallback(window, mouse_button_callback);
 
 	// GLAD: carrega todos os ponteiros d funções da OpenGL
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
@@ -109,33 +214,44 @@ int main()
 	// Compilando e buildando o programa de shader
 	GLuint shaderID = setupShader();
 
-	// Gerando um buffer simples, com a geometria de um triângulo
-	GLuint VAO = setupGeometry();
-	
+	// Índices dos tiles e paleta em texturas (ou chunks de quads coloridos no modo --world)
+	if (!setupTileMap(columns, rows))
+	{
+		glfwTerminate();
+		return -1;
+	}
 
 	// Enviando a cor desejada (vec4) para o fragment shader
 	// Utilizamos a variáveis do tipo uniform em GLSL para armazenar esse tipo de info
 	// que não está nos buffers
-	GLint colorLoc = glGetUniformLocation(shaderID, "inputColor");
+	// O Shader guarda o último valor de cada uniform e só envia o que mudou
+	Shader shader(shaderID);
 	
-	glUseProgram(shaderID);
+	shader.Use();
+
+	// No modo --world a cor vem dos vértices dos chunks, já em coordenadas de mundo
+	if (worldMode)
+	{
+		mat4 model = mat4(1);
+		shader.setMat4("model", value_ptr(model));
+		shader.setVec4("inputColor", 1.0f, 1.0f, 1.0f, 1.0f);
+	}
 	
+	// Câmera e dados do frame ficam num uniform buffer compartilhado por todos os shaders
+	FrameUniforms frame;
+	frame.init();
+	ShaderLibrary::get().bindUniformBlock("FrameData", FRAME_DATA_BINDING);
+
 	// Matriz de projeção paralela ortográfica
-	mat4 projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);
-	GLint projLoc = glGetUniformLocation(shaderID, "projection");
-	glUniformMatrix4fv(projLoc, 1, GL_FALSE, value_ptr(projection));
-
-	// Matriz de modelo: trasformações na geometria (objeto)
-	mat4 model = mat4(1); // matriz identidade
-	// Translação
-	//model = translate(model, vec3(400.0, 300.0, 0.0));
-	// Rotação            ângulo          eixo   x    y    z    
-	//model = rotate(model, radians(45.0f), vec3(0.0, 0.0, 1.0));
-	// Escala
-	//model = scale(model, vec3(0.5, 0.5, 1.0));
-
-	GLint modelLoc = glGetUniformLocation(shaderID, "model");
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, value_ptr(model));
+	frame.data.projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);
+	frame.data.viewport = vec2(width, height);
+
+	double lastTime = glfwGetTime(), lastReport = lastTime;
+	int rebuildsSinceReport = 0;
+
+	// Uniforms enviados / evitados, somados e mostrados uma vez por segundo
+	Shader::UniformStats uniformsSinceReport;
+	double uniformReportTime = glfwGetTime();
 
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
@@ -143,24 +259,62 @@ int main()
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
 
+		// Câmera: as setas movem a janela de 800 x 600 pelo mundo
+		double now = glfwGetTime();
+		float dt = (float)(now - lastTime);
+		lastTime = now;
+		vec2 move = vec2(0.0f);
+		if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) move.x -= 1.0f;
+		if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) move.x += 1.0f;
+		if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) move.y -= 1.0f;
+		if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) move.y += 1.0f;
+		camera += move * CAMERA_SPEED * dt;
+		frame.data.view = translate(mat4(1), vec3(-camera, 0.0f));
+
+		// Atualiza o bloco FrameData uma única vez por frame
+		frame.data.time = now;
+		frame.update();
+
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); //cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT);
 
-		glLineWidth(10);
-		glPointSize(20);
-
-		glBindVertexArray(VAO); //Conectando ao buffer de geometria
-
-		drawSquares(shaderID);
-
-		glBindVertexArray(0); //Desconectando o buffer de geometria
+		if (worldMode)
+		{
+			// Só os chunks que cruzam a tela; só os alterados são remontados
+			worldMap.draw(camera, camera + vec2(WIDTH, HEIGHT));
+			const ChunkedTileMap::Stats& stats = worldMap.stats();
+			rebuildsSinceReport += stats.rebuilds;
+			if (now - lastReport >= 1.0)
+			{
+				cout << "Chunks visiveis: " << stats.visibleChunks << ", remontados no ultimo segundo: "
+					<< rebuildsSinceReport << ", no cache: " << stats.residentChunks << " ("
+					<< stats.residentBytes / 1024 << " KB)" << endl;
+				rebuildsSinceReport = 0;
+				lastReport = now;
+			}
+		}
+		else
+		{
+			// A grade inteira numa draw call; só os tiles alterados são reenviados
+			tileMap.draw(shader);
+		}
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
+
+		// Contadores de uniforms enviados / evitados neste frame
+		Shader::UniformStats uniforms = Shader::endFrame();
+		uniformsSinceReport.sent += uniforms.sent;
+		uniformsSinceReport.skipped += uniforms.skipped;
+		if (glfwGetTime() - uniformReportTime >= 1.0)
+		{
+			cout << "Uniforms no ultimo segundo: " << uniformsSinceReport.sent << " enviados, "
+				<< uniformsSinceReport.skipped << " evitados" << endl;
+			uniformsSinceReport = Shader::UniformStats();
+			uniformReportTime = glfwGetTime();
+		}
 	}
-	// Pede pra OpenGL desalocar os buffers
-	glDeleteVertexArrays(1, &VAO);
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
 	return 0;
@@ -175,178 +329,79 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 		glfwSetWindowShouldClose(window, GL_TRUE);
 }
 
-//Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
-// shader simples e único neste exemplo de código
-// O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-// fragmentShader source no iniçio deste arquivo
-// A função retorna o identificador do programa de shader
-int setupShader()
+// Clique com o botão esquerdo: o tile sob o cursor passa para a próxima cor da paleta
+// (só esse tile é reenviado no próximo desenho)
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
+	if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS)
+		return;
+
+	double x, y;
+	glfwGetCursorPos(window, &x, &y);
+	int windowWidth, windowHeight;
+	glfwGetWindowSize(window, &windowWidth, &windowHeight);
+	// Cursor em coordenadas da janela (y para baixo) para a projeção de 800 x 600 (y para cima),
+	// deslocado pela câmera
+	float px = (float)x * WIDTH / windowWidth + camera.x, py = HEIGHT - (float)y * HEIGHT / windowHeight + camera.y;
+	int column = (int)floor(px / tileSize), row = (int)floor(py / tileSize);
+	if (worldMode)
 	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+		if (column >= 0 && column < worldMap.columns() && row >= 0 && row < worldMap.rows())
+		{
+			worldMap.setTile(column, row, (worldMap.tile(column, row) + 1) % N_COLORS);
+		}
 	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
+	else if (column >= 0 && column < tileMap.columns() && row >= 0 && row < tileMap.rows())
 	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success) {
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+		tileMap.setTile(column, row, (tileMap.tile(column, row) + 1) % N_COLORS);
 	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
 }
 
-// Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a 
-// geometria de um triângulo
-// Apenas atributo coordenada nos vértices
-// 1 VBO com as coordenadas, VAO com apenas 1 ponteiro para atributo
-// A função retorna o identificador do VAO
-int setupGeometry()
+// Pede o shader de tilemap (índice do tile numa textura, cor na paleta), ou no modo --world
+// a variante do shader de sprite com cor por vértice
+// O código fonte fica em Common/include/ShaderSources.h, compartilhado com os outros programas
+// A função espera o programa ficar pronto e retorna o seu identificador
+int setupShader()
 {
-	// Aqui setamos as coordenadas x, y e z do triângulo e as armazenamos de forma
-	// sequencial, já visando mandar para o VBO (Vertex Buffer Objects)
-	// Cada atributo do vértice (coordenada, cores, coordenadas de textura, normal, etc)
-	// Pode ser arazenado em um VBO único ou em VBOs separados
-	GLfloat vertices[] = {
-		//x   y     z
-		//T0
-		  0.0, 0.0, 0.0, //v0
-		  100, 0.0, 0.0, //v1
- 		  100, 100, 0.0, //v2
-		  0.0, 100, 0.0
-	};
-
-	GLuint VBO, VAO;
-	//Geração do identificador do VBO
-	glGenBuffers(1, &VBO);
-	//Faz a conexão (vincula) do buffer como um buffer de array
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	//Envia os dados do array de floats para o buffer da OpenGl
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	//Geração do identificador do VAO (Vertex Array Object)
-	glGenVertexArrays(1, &VAO);
-	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-	// e os ponteiros para os atributos 
-	glBindVertexArray(VAO);
-	//Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando: 
-	// Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-	// Numero de valores que o atributo tem (por ex, 3 coordenadas xyz) 
-	// Tipo do dado
-	// Se está normalizado (entre zero e um)
-	// Tamanho em bytes 
-	// Deslocamento a partir do byte zero 
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
-	glEnableVertexAttribArray(0);
-
-	// Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice 
-	// atualmente vinculado - para que depois possamos desvincular com segurança
-	glBindBuffer(GL_ARRAY_BUFFER, 0); 
-
-	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0); 
-
-	return VAO;
+	if (worldMode)
+	{
+		return spriteShaders.get(ShaderVariants::VERTEX_COLOR);
+	}
+	return tilemapShaders.get(0);
 }
 
-void drawSquares(GLuint shaderID)
+// Cria o mapa com columns x rows tiles a partir de (0, 0) e preenche paleta e tiles
+// As cores são escolhidas uma vez aqui, não a cada frame
+bool setupTileMap(int columns, int rows)
 {
-	for( int i = 0; i < 6; i++)
+	if (worldMode)
 	{
-		for(int j = 0; j < 8; j++)
+		if (!worldMap.init(columns, rows, vec2(tileSize)))
 		{
-			mat4 model = mat4(1); 
-			// Translação
-			model = translate(model, vec3(j * 100, i * 100, 0.0));
-
-			vec3 color;
-
-			if (i % 4 == 0 && j % 4 == 0)
-			{
-				color = vec3(0.9f, 0.9f, 0.0f);
-			}
-			else if (i % 3 == 2 && j % 3 == 1)
-			{
-				color = vec3(0.8f, 0.4f, 0.8f);
-			}
-			else if (i % 2 == 0 && j % 6 == 0)
-			{
-				color = vec3(0.0f, 0.7f, 1.0f);
-			}
-			else if (i % 5 == 2 && j % 3 == 2)
-			{
-				color = vec3(0.9f, 0.0f, 0.0f);
-			}
-			else if (i % 2 == 0 && j % 4 == 3)
-			{
-				color = vec3(0.1f, 1.0f, 0.1f);
-			}
-			else if (i % 2 == 1 && j % 4 == 3)
-			{
-				color = vec3(0.1f, 1.0f, 1.0f);
-			}
-			else if (i % 3 == 1 && j % 3 == 2)
-			{
-				color = vec3(0.6f, 0.3f, 0.0f);
-			}
-			else if (i % 3 == 0 && j % 2 == 0)
-			{
-				color = vec3(0.3f, 0.0f, 0.5f);
-			}
-			else if (i % 3 == 0 && j % 2 == 0)
-			{
-				color = vec3(0.3f, 0.0f, 0.5f);
-			}
-			else if (i % 2 == 1 && j % 2 == 1)
-			{
-				color = vec3(1.0f, 0.1f, 0.6f);
-			}
-			else if (i % 2 == 1 && j % 2 == 0)
-			{
-				color = vec3(0.4f, 0.5f, 0.0f);
-			}
-			else if (i % 2 == 0 && j % 2 == 1)
-			{
-				color = vec3(0.9f, 0.5f, 0.0f);
-			}
-			else 
-			{
-				color = vec3(0.5f, 0.5f, 0.5f);
-			}
-
-			glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-
-			glUniform4f(glGetUniformLocation(shaderID, "inputColor"), color.r, color.g, color.b, 1.0f);
-
-			glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-			
+			return false;
 		}
+		for (int c = 0; c < N_COLORS; c++)
+		{
+			worldMap.setPaletteColor(c, Palette::toVec4(COLORS[c]));
+		}
+		worldMap.fill([](int column, int row) { return tileFor(row, column); });
+		return true;
+	}
+	if (!tileMap.init(columns, rows, vec2(tileSize), vec2(0.0f)))
+	{
+		return false;
+	}
+	for (int c = 0; c < N_COLORS; c++)
+	{
+		tileMap.setPaletteColor(c, Palette::toVec4(COLORS[c]));
 	}
-}
\ No newline at end of file
+	// fill passa (coluna, linha); tileFor recebe (linha, coluna)
+	tileMap.fill([](int column, int row) { return tileFor(row, column); });
+	return true;
+}
+
+// Índice na paleta do quadrado da linha i, coluna j (uma leitura da tabela)
+int tileFor(int i, int j)
+{
+	return SQUARE_PATTERN.at(i, j);
+}
@@ -19,11 +19,21 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
+// Biblioteca de shaders e variantes por features (Common/include)
+#include "ShaderLibrary.h"
+#include "ShaderVariants.h"
+
 //GLM
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Uniform buffer com câmera e dados do frame (Common/include)
+#include "FrameUniforms.h"
+
+// Envio de uniforms sem repetir valores (Common/include)
+#include "Shader.h"
+
 #include <cmath>
 
 using namespace glm;
@@ -37,30 +47,13 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 int setupShader();
 int setupGeometry();
 
-void drawTriangle(GLuint shaderID, GLuint VAO, vec3 position, vec3 dimensions, float angle, vec3 color, vec3 axis = (vec3(0.0, 0.0, 1.0)));
+void drawTriangle(Shader &shader, GLuint VAO, vec3 position, vec3 dimensions, float angle, vec3 color, vec3 axis = (vec3(0.0, 0.0, 1.0)));
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
 
-// Código fonte do Vertex Shader (em GLSL): ainda hardcoded
-const GLchar* vertexShaderSource = "#version 400\n"
-"uniform mat4 projection;\n"
-"uniform mat4 model;\n"
-"layout (location = 0) in vec3 position;\n"
-"void main()\n"
-"{\n"
-//...pode ter mais linhas de código aqui!
-"gl_Position = projection * model * vec4(position.x, position.y, position.z, 1.0);\n"
-"}\0";
-
-//Códifo fonte do Fragment Shader (em GLSL): ainda hardcoded
-const GLchar* fragmentShaderSource = "#version 400\n"
-"uniform vec4 inputColor;\n"
-"out vec4 color;\n"
-"void main()\n"
-"{\n"
-"color = inputColor;\n"
-"}\n\0";
+// Shaders de sprite: código fonte único em Common/include/ShaderSources.h
+ShaderVariants spriteShaders("sprite.vs", "sprite.fs");
 
 int dir = NONE;
 
@@ -119,14 +112,19 @@ int main()
 	// Enviando a cor desejada (vec4) para o fragment shader
 	// Utilizamos a variáveis do tipo uniform em GLSL para armazenar esse tipo de info
 	// que não está nos buffers
-	GLint colorLoc = glGetUniformLocation(shaderID, "inputColor");
+	// O Shader guarda o último valor de cada uniform e só envia o que mudou
+	Shader shader(shaderID);
 	
-	glUseProgram(shaderID);
+	shader.Use();
 	
+	// Câmera e dados do frame ficam num uniform buffer compartilhado por todos os shaders
+	FrameUniforms frame;
+	frame.init();
+	ShaderLibrary::get().bindUniformBlock("FrameData", FRAME_DATA_BINDING);
+
 	// Matriz de projeção paralela ortográfica
-	mat4 projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);
-	GLint projLoc = glGetUniformLocation(shaderID, "projection");
-	glUniformMatrix4fv(projLoc, 1, GL_FALSE, value_ptr(projection));
+	frame.data.projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);
+	frame.data.viewport = vec2(width, height);
 
 	// Matriz de modelo: trasformações na geometria (objeto)
 	mat4 model = mat4(1); // matriz identidade
@@ -137,25 +135,29 @@ int main()
 	// Escala
 	//model = scale(model, vec3(0.5, 0.5, 1.0));
 
-	GLint modelLoc = glGetUniformLocation(shaderID, "model");
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, value_ptr(model));
+	shader.setMat4("model", value_ptr(model));
 
 	vec3 position = vec3(400.0, 300.0, 0.0);
 	float vel = 0.7;
 
+	// Uniforms enviados / evitados, somados e mostrados uma vez por segundo
+	Shader::UniformStats uniformsSinceReport;
+	double uniformReportTime = glfwGetTime();
+
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
 	{
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
 
+		// Atualiza o bloco FrameData uma única vez por frame
+		frame.data.time = glfwGetTime();
+		frame.update();
+
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); //cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT);
 
-		glLineWidth(10);
-		glPointSize(20);
-
 		glBindVertexArray(VAO); //Conectando ao buffer de geometria
 
 		if(dir == UP)
@@ -175,12 +177,24 @@ int main()
 			position.x += vel;
 		}
 
-		drawTriangle(shaderID, VAO, position, vec3(1.0, 1.0, 1.0), 0.0, vec3(0.0f, 0.0f, 1.0f), vec3(0.0, 0.0, 1.0));
+		drawTriangle(shader, VAO, position, vec3(1.0, 1.0, 1.0), 0.0, vec3(0.0f, 0.0f, 1.0f), vec3(0.0, 0.0, 1.0));
 
 		glBindVertexArray(0); //Desconectando o buffer de geometria
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
+
+		// Contadores de uniforms enviados / evitados neste frame
+		Shader::UniformStats uniforms = Shader::endFrame();
+		uniformsSinceReport.sent += uniforms.sent;
+		uniformsSinceReport.skipped += uniforms.skipped;
+		if (glfwGetTime() - uniformReportTime >= 1.0)
+		{
+			cout << "Uniforms no ultimo segundo: " << uniformsSinceReport.sent << " enviados, "
+				<< uniformsSinceReport.skipped << " evitados" << endl;
+			uniformsSinceReport = Shader::UniformStats();
+			uniformReportTime = glfwGetTime();
+		}
 	}
 	// Pede pra OpenGL desalocar os buffers
 	glDeleteVertexArrays(1, &VAO);
@@ -220,52 +234,12 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 	
 }
 
-//Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
-// shader simples e único neste exemplo de código
-// O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-// fragmentShader source no iniçio deste arquivo
-// A função retorna o identificador do programa de shader
+// Pede a variante básica do shader de sprite (cor sólida vinda do uniform inputColor)
+// O código fonte fica em Common/include/ShaderSources.h, compartilhado com os outros programas
+// A função espera o programa ficar pronto e retorna o seu identificador
 int setupShader()
 {
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success) {
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
+	return spriteShaders.get(0);
 }
 
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a 
@@ -320,7 +294,7 @@ int setupGeometry()
 	return VAO;
 }
 
-void drawTriangle(GLuint shaderID, GLuint VAO, vec3 position, vec3 dimensions, float angle, vec3 color, vec3 axis)
+void drawTriangle(Shader &shader, GLuint VAO, vec3 position, vec3 dimensions, float angle, vec3 color, vec3 axis)
 {
 	mat4 model = mat4(1); 
 	// Translação
@@ -330,9 +304,9 @@ void drawTriangle(GLuint shaderID, GLuint VAO, vec3 position, vec3 dimensions, f
 	// Escala
 	model = scale(model, dimensions);
 
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+	shader.setMat4("model", value_ptr(model));
 
-	glUniform4f(glGetUniformLocation(shaderID, "inputColor"), color.r, color.g, color.b, 1.0f);
+	shader.setVec4("inputColor", color.r, color.g, color.b, 1.0f);
 
 	// Chamada de desenho - drawcall
 	// Poligono Preenchido - GL_TRIANGLES
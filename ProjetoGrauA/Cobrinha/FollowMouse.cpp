@@ -27,6 +27,48 @@
 
 #include <cmath>
 #include <vector>
+#include <cstddef>
+#include <algorithm>
+
+// Biblioteca de shaders (compilação assíncrona e cache de binários) e variantes por features
+#include "ShaderLibrary.h"
+#include "ShaderVariants.h"
+
+// Uniform buffer com câmera e dados do frame
+#include "FrameUniforms.h"
+
+// Solver vetorizado da corrente de segmentos
+#include "ChainSolver.h"
+
+// Histórico do caminho da cabeça (posicionamento por comprimento de arco)
+#include "PathHistory.h"
+
+// Corpo contínuo (fita com pontas arredondadas)
+#include "RibbonMesh.h"
+
+// Trechos do VAO dos olhos desenhados em lote
+#include "DrawBatch.h"
+
+// Grade uniforme para a colisão da cabeça com o corpo
+#include "SegmentGrid.h"
+
+// Enxame de cobrinhas atualizado em paralelo
+#include "Swarm.h"
+
+// Eventos de movimento do mouse entre os frames
+#include "CursorStream.h"
+
+// Malhas procedurais em cache, com divisões escolhidas pelo tamanho na tela
+#include "MeshLibrary.h"
+
+// Memória temporária do frame (Common/include)
+#include "FrameArena.h"
+
+// Transformações com pai e filhos (Common/include)
+#include "SceneGraph.h"
+
+// Tabelas de cores geradas na compilação (Common/include)
+#include "Palette.h"
 
 using namespace std;
 using namespace glm;
@@ -35,12 +77,10 @@ using namespace glm;
 const float Pi = 3.14159265;
 const GLuint WIDTH = 800, HEIGHT = 600; // Dimensões da janela
 
-// Estrutura para armazenar informações sobre as geometrias da cena
+// Malha, tamanho e cor de uma geometria da cena (posição e ângulo ficam no grafo de cena)
 struct Geometry 
 {
     GLuint VAO;        // Vertex Array Geometry
-    vec3 position;     // Posição do objeto
-    float angle;       // Ângulo de rotação
     vec3 dimensions;   // Escala do objeto (largura, altura)
     vec3 color;        // Cor do objeto
     int nVertices;     // Número de vértices a desenhar
@@ -54,23 +94,96 @@ float smoothFactor = 0.1;
 float maxDistance = 0.1;
 float minDistance = 0.05;
 bool addNew = false;
-vector<Geometry> cobrinha; // Vetor que armazena os segmentos da cobrinha
+Geometry body;             // Malha e tamanho da cabeça, comuns a todos os segmentos
+ChainSolver::Chain chain;  // Posições dos segmentos em SoA (índice 0 = cabeça)
+
+// Modo de histórico do caminho (tecla M alterna com o solver da corrente): os segmentos ficam
+// sobre o caminho percorrido pela cabeça, exatamente a segmentSpacing pixels um do outro
+bool usePathHistory = true;
+float segmentSpacing = 20.0;
+PathHistory path;
+
+// Colisão da cabeça com o corpo: a grade é refeita a cada frame sobre os centros dos segmentos
+SegmentGrid grid;
+bool colliding = false; // a cabeça está encostada no corpo (avisa só quando começa)
+
+// Modo enxame (tecla W ou FollowMouse.exe --swarm <cobrinhas>): milhares de cobrinhas com alvos
+// aleatórios, atualizadas em paralelo e desenhadas junto em um único draw instanciado
+bool swarmMode = false;
+size_t swarmSnakes = 2000;
+const size_t SWARM_LENGTH = 24;
+const vec3 SWARM_DIMENSIONS = vec3(10, 10, 1.0);
+Swarm swarm;
+WorkerPool workers;
+
+// Todos os movimentos do mouse (callback), não só a posição no início do frame: a cabeça
+// passa por cada um, e o corpo acompanha traços rápidos. Tecla R: movimento bruto do mouse
+CursorStream cursor;
+vector<CursorStream::Sample> cursorEvents;
+const size_t MAX_SOLVER_SUBSTEPS = 8; // passos do solver por frame, no máximo, no modo corrente
 Geometry eyes; // Objeto que representa os olhos da cobrinha
 
+// Os olhos são filhos da cabeça: só a cabeça recebe posição e ângulo, e a matriz dos olhos
+// é recalculada quando ela muda
+SceneGraph scene;
+int headNode, eyesNode;
+DrawBatch eyeBatch; // Escleras e pupilas: 4 leques com a cor no vértice, 1 draw call
+
+// Corpo desenhado com instancing: uma única malha de círculo para todos os segmentos e um
+// buffer com os dados de cada instância (posição e cor do segmento), reenviado a cada frame.
+// As instâncias são montadas na arena do frame
+struct SegmentInstance
+{
+    vec3 offset; // posição do segmento (atributo 3 do shader)
+    vec4 color;  // cor do segmento (atributo 4 do shader)
+};
+Mesh bodyMesh, swarmMesh;        // Círculos dos segmentos e do enxame (MeshLibrary)
+GLuint instanceVBO = 0;          // Buffer de instâncias
+size_t instanceCapacity = 0;     // Quantas instâncias cabem no buffer alocado
+
+// Dados que só valem durante o frame; liberados de uma vez depois de glfwSwapBuffers
+FrameArena frameArena;
+
+// Corpo como uma fita contínua ao longo dos segmentos (tecla B alterna com os círculos):
+// um único triangle strip, sem a sobreposição dos círculos
+bool drawRibbon = true;
+RibbonMesh ribbon;
+ShaderVariants spriteShaders("sprite.vs", "sprite.fs"); // Shaders de sprite (ShaderSources.h)
+
 // Protótipos das funções
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
-int setupShader();           // Função para configurar os shaders
-void drawGeometry(GLuint shaderID, GLuint VAO, int nVertices, vec3 position, vec3 dimensions, float angle, vec3 color, GLuint drawingMode = GL_TRIANGLES, int offset = 0, vec3 axis = vec3(0.0, 0.0, 1.0));
-Geometry createSegment(int i, vec3 dir);
+void cursor_callback(GLFWwindow *window, double xpos, double ypos);
+ShaderFuture setupShader(); // Função para configurar os shaders
+GLuint createInstancedVAO(const Mesh& mesh);
+void drawBody(GLuint shaderID);
+void drawSwarm(GLuint shaderID);
+void drawInstances(GLuint shaderID, const Mesh& mesh, vec3 dimensions, const FrameVector<SegmentInstance>& instances);
+void startSwarm();
+void drawBodyRibbon(GLuint shaderID);
+void drawBatch(GLuint shaderID, DrawBatch& batch, const mat4& model);
+void addSegment(vec3 dir);
+vec3 segmentColor(int i);
 int createEyes(int nPoints, float radius);
-int createCircle(int nPoints, float radius, float xc = 0.0, float yc = 0.0);
 
-int main() {
+int main(int argc, char** argv) {
+    // FollowMouse.exe --bench: compara o laço original com o solver da corrente e sai
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        ChainSolver::benchmark();
+        SegmentGrid::benchmark();
+        MeshLibrary::benchmark();
+        return 0;
+    }
+    if (argc > 2 && string(argv[1]) == "--swarm") {
+        swarmSnakes = std::max((size_t)atol(argv[2]), (size_t)1);
+        swarmMode = true;
+    }
+
     // Inicializa GLFW e configurações de versão do OpenGL
     glfwInit();
     GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Cobrinha", nullptr, nullptr);
     glfwMakeContextCurrent(window);
     glfwSetKeyCallback(window, key_callback);
+    glfwSetCursorPosCallback(window, cursor_callback);
 
     // Inicializa GLAD para carregar todas as funções OpenGL
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
@@ -88,105 +201,211 @@ int main() {
     int width, height;
     glfwGetFramebufferSize(window, &width, &height);
     glViewport(0, 0, width, height);
+    cursor.init(window);
 
-    GLuint shaderID = setupShader();
+    // Submete o programa de shader: ele compila enquanto a geometria é criada
+    ShaderFuture shaderFuture = setupShader();
+    // Variante com instancing, para o corpo em círculos
+    ShaderFuture bodyShaderFuture = spriteShaders.request(ShaderVariants::INSTANCED);
+
+    // Matriz de projeção ortográfica (usada para desenhar em 2D)
+    mat4 projection = ortho(0.0f, 800.0f, 0.0f, 600.0f, -1.0f, 1.0f);
+
+    // Círculos com as divisões pelo raio na tela (os do enxame são bem menores). Os VAOs da
+    // MeshLibrary são compartilhados: cada malha ganha aqui um VAO próprio, sobre o mesmo VBO,
+    // com os atributos do buffer de instâncias
+    body.dimensions = vec3(50, 50, 1.0);
+    bodyMesh = MeshLibrary::get().circleForScreen(MeshLibrary::screenRadius(0.5f * body.dimensions.x, projection, vec2(width, height)));
+    swarmMesh = MeshLibrary::get().circleForScreen(MeshLibrary::screenRadius(0.5f * SWARM_DIMENSIONS.x, projection, vec2(width, height)));
+    bodyMesh.VAO = createInstancedVAO(bodyMesh);
+    swarmMesh.VAO = createInstancedVAO(swarmMesh);
+    ribbon.init();
 
     // Criação da cabeça
-    Geometry head = createSegment(0, dir);
-    cobrinha.push_back(head);
+    body.VAO = bodyMesh.VAO;
+    body.nVertices = bodyMesh.count;
+    addSegment(dir);
+
+    // O histórico começa com um trecho reto atrás da cabeça
+    path.reset(chain.x[0], chain.y[0], dir.x, dir.y, segmentSpacing);
 
     // Criação dos olhos
     eyes.VAO = createEyes(32, 0.25);
     eyes.nVertices = 34;
-    eyes.position = vec3(400, 300, 0.0);
     eyes.dimensions = vec3(50, 50, 1.0);
-    eyes.angle = 0.0;
     eyes.color = vec3(1.0, 1.0, 1.0);
+    eyeBatch.init(eyes.VAO, 4 * eyes.nVertices);
+    eyeBatch.add(GL_TRIANGLE_FAN, 0, eyes.nVertices, eyes.color);
+    eyeBatch.add(GL_TRIANGLE_FAN, eyes.nVertices, eyes.nVertices, eyes.color);
+    eyeBatch.add(GL_TRIANGLE_FAN, 2 * eyes.nVertices, eyes.nVertices, vec3(0.0, 0.0, 0.0));
+    eyeBatch.add(GL_TRIANGLE_FAN, 3 * eyes.nVertices, eyes.nVertices, vec3(0.0, 0.0, 0.0));
+    headNode = scene.add();
+    scene.setPosition(headNode, vec3(400, 300, 0.0));
+    eyesNode = scene.add(headNode);
+    scene.setScale(eyesNode, eyes.dimensions);
 
     // Ativa o teste de profundidade
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_ALWAYS); // Sempre passa no teste de profundidade (desnecessário se não houver profundidade)
 
-    glUseProgram(shaderID);
+    GLuint shaderID = shaderFuture.get();
+    GLuint bodyShaderID = bodyShaderFuture.get();
 
-    // Matriz de projeção ortográfica (usada para desenhar em 2D)
-    mat4 projection = ortho(0.0f, 800.0f, 0.0f, 600.0f, -1.0f, 1.0f);
-    glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+    // Câmera e dados do frame ficam num uniform buffer compartilhado por todos os shaders
+    FrameUniforms frame;
+    frame.init();
+    ShaderLibrary::get().bindUniformBlock("FrameData", FRAME_DATA_BINDING);
+
+    frame.data.projection = projection;
+    frame.data.viewport = vec2(width, height);
+
+    if (swarmMode)
+    {
+        startSwarm();
+    }
+    double lastTime = glfwGetTime();
+    // Medição do enxame: segmentos atualizados e tempo gasto, relatados a cada segundo
+    double swarmSeconds = 0.0, swarmReportTime = lastTime;
+    size_t swarmUpdated = 0;
+    int swarmFrames = 0;
 
     // Loop da aplicação
     while (!glfwWindowShouldClose(window)) {
         // Processa entradas (teclado e mouse)
         glfwPollEvents();
 
+        // Atualiza o bloco FrameData uma única vez por frame
+        frame.data.time = glfwGetTime();
+        frame.update();
+        float dt = (float)std::min(frame.data.time - lastTime, 0.1);
+        lastTime = frame.data.time;
+
+        if (swarmMode)
+        {
+            double start = glfwGetTime();
+            swarm.update(dt, workers);
+            swarmSeconds += glfwGetTime() - start;
+            swarmUpdated += swarm.segments();
+            swarmFrames++;
+            if (lastTime - swarmReportTime >= 1.0 && swarmFrames > 0)
+            {
+                cout << "Enxame: " << swarm.snakes() << " cobrinhas, " << swarmUpdated / swarmSeconds / 1.0e6
+                     << " milhoes de segmentos/s (" << swarmSeconds / swarmFrames * 1.0e3 << " ms por frame, "
+                     << workers.size() << " threads)" << endl;
+                swarmSeconds = 0.0;
+                swarmUpdated = 0;
+                swarmFrames = 0;
+                swarmReportTime = lastTime;
+            }
+        }
+
         // Limpa a tela
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Pega a posição do mouse e calcula a direção
-        double xPos, yPos;
-        glfwGetCursorPos(window, &xPos, &yPos);
-        mousePos = vec2(xPos, height - yPos);  // Inverte o eixo Y para se alinhar à tela
+        // Movimentos do mouse desde o último frame; a posição atual é a do último
+        cursor.drain(cursorEvents);
+        mousePos = vec2(cursor.last().x, height - cursor.last().y);  // Inverte o eixo Y para se alinhar à tela
         float lookangle = atan2(dir.y, dir.x);
 
-        dir = normalize(vec3(mousePos, 0.0) - vec3(mousePos, 0.0));
+        // Direção da cabeça para o mouse (mantém a anterior se o mouse está sobre a cabeça)
+        vec3 toMouse = vec3(mousePos, 0.0) - vec3(chain.x[0], chain.y[0], 0.0);
+        if (length(toMouse) > 0.0f)
+        {
+            dir = normalize(toMouse);
+        }
         vec3 position = vec3(mousePos, 0.0) + 0.2f * dir;
 
-        cobrinha[0].position = position;
-        cobrinha[0].angle = lookangle;
-        eyes.position = position;
-        eyes.angle = lookangle;
+        chain.x[0] = position.x;
+        chain.y[0] = position.y;
+        scene.setPosition(headNode, position);
+        scene.setAngle(headNode, lookangle);
 
-        for (int i = 1; i < cobrinha.size(); i++)
+        if (addNew)
         {
-            vec3 dir = normalize(cobrinha[i - 1].position - cobrinha[i].position);
-            float distance = length(cobrinha[i - 1].position - cobrinha[i].position);
-
-            vec3 targetPosition = cobrinha[i].position;
-            float dynamicSmoothFactor = smoothFactor * (distance / maxDistance);
+            addSegment(-dir);
+            addNew = false;
+        }
 
-            if (distance < minDistance)
+        if (usePathHistory)
+        {
+            // Segmento j no ponto do caminho a j * segmentSpacing atrás da cabeça. Os pontos
+            // intermediários do mouse entram no caminho antes da posição atual
+            for (size_t e = 0; e + 1 < cursorEvents.size(); e++)
             {
-                targetPosition = cobrinha[i].position + (distance - minDistance) * dir;
+                path.append(cursorEvents[e].x, height - cursorEvents[e].y);
             }
-            else if (distance > maxDistance)
+            path.append(position.x, position.y);
+            path.setRequiredLength(segmentSpacing * (chain.size() - 1));
+            path.sampleChain(segmentSpacing, chain.size(), chain.x.data(), chain.y.data());
+        }
+        else
+        {
+            // Cada segmento segue o anterior, mantendo a distância entre minDistance e maxDistance.
+            // Um passo por evento intermediário (até MAX_SOLVER_SUBSTEPS - 1, espalhados pelos
+            // eventos do frame) e o último com a cabeça na posição atual
+            ChainSolver::Params params{ smoothFactor, minDistance, maxDistance };
+            size_t substeps = std::min(cursorEvents.size(), MAX_SOLVER_SUBSTEPS);
+            for (size_t k = 1; k < substeps; k++)
             {
-                targetPosition = cobrinha[i].position + (distance - maxDistance) * dir;
+                const CursorStream::Sample& e = cursorEvents[k * cursorEvents.size() / substeps - 1];
+                chain.x[0] = e.x;
+                chain.y[0] = height - e.y;
+                ChainSolver::solve(chain, params);
             }
-
-            cobrinha[i].position = mix(cobrinha[i].position, targetPosition, dynamicSmoothFactor);
+            chain.x[0] = position.x;
+            chain.y[0] = position.y;
+            ChainSolver::solve(chain, params);
         }
 
-        if (addNew)
+        // Colisão da cabeça com um segmento que não seja vizinho dela. Os segmentos a menos de
+        // um quarto de volta (pi/2 diâmetros de caminho) encostam na cabeça em qualquer curva
+        float diameter = body.dimensions.x;
+        float spacing = usePathHistory ? segmentSpacing : maxDistance;
+        size_t minGap = (size_t)ceil(0.5f * Pi * diameter / spacing);
+        grid.build(chain.x.data(), chain.y.data(), chain.size(), diameter);
+        long hit = grid.query(chain.x[0], chain.y[0], diameter, minGap);
+        if (hit >= 0 && !colliding)
         {
-            cobrinha.push_back(createSegment(cobrinha.size(), -dir));
-            addNew = false;
+            cout << "Colisao: a cabeca encostou no segmento " << hit << endl;
         }
+        colliding = hit >= 0;
 
-        for (int i = cobrinha.size() - 1; i >= 0; i--)
+        // Enxame por baixo da cobrinha do mouse
+        if (swarmMode)
         {
-            drawGeometry(shaderID, cobrinha[i].VAO, cobrinha[i].nVertices, 
-                cobrinha[i].position, cobrinha[i].dimensions, cobrinha[i].angle,
-                cobrinha[i].color, GL_TRIANGLE_FAN);
-
-            if (i == 0)
-            {
-                drawGeometry(shaderID, eyes.VAO, eyes.nVertices, eyes.position,
-                eyes.dimensions, eyes.angle, eyes.color, GL_TRIANGLE_FAN, 0);
-                drawGeometry(shaderID, eyes.VAO, eyes.nVertices, eyes.position,
-                eyes.dimensions, eyes.angle, eyes.color, GL_TRIANGLE_FAN, 34);
-
-                drawGeometry(shaderID, eyes.VAO, eyes.nVertices, eyes.position,
-                eyes.dimensions, eyes.angle, vec3(0.0, 0.0, 0.0), GL_TRIANGLE_FAN, 2 *34);
-                drawGeometry(shaderID, eyes.VAO, eyes.nVertices, eyes.position,
-                eyes.dimensions, eyes.angle, vec3(0.0, 0.0, 0.0), GL_TRIANGLE_FAN, 3 * 34);
-            }
+            glUseProgram(bodyShaderID);
+            drawSwarm(bodyShaderID);
+        }
 
+        // Corpo inteiro (cabeça inclusa) em um único draw call
+        if (drawRibbon)
+        {
+            glUseProgram(shaderID);
+            drawBodyRibbon(shaderID);
         }
+        else
+        {
+            glUseProgram(bodyShaderID);
+            drawBody(bodyShaderID);
+        }
+
+        // Olhos, por cima da cabeça (escleras e pupilas em um draw call)
+        scene.update();
+        glUseProgram(shaderID);
+        drawBatch(shaderID, eyeBatch, scene.world(eyesNode));
 
         // Troca os buffers da tela
         glfwSwapBuffers(window);
+
+        // Fim do frame: a memória temporária volta toda para a arena
+        frameArena.reset();
     }
 
+    // Quanto a arena do frame precisou (para ajustar a capacidade inicial)
+    cout << "Arena do frame: pico de " << frameArena.peak() / 1024 << " KB, capacidade "
+         << frameArena.capacity() / 1024 << " KB (cresceu " << frameArena.growths() << " vezes)" << endl;
+
     // Limpa a memória alocada pelos buffers
     glfwTerminate();
     return 0;
@@ -200,6 +419,43 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
     {
         addNew = true;
     }
+    if (key == GLFW_KEY_B && action == GLFW_PRESS)
+    {
+        drawRibbon = !drawRibbon;
+        cout << "Corpo: " << (drawRibbon ? "fita continua" : "circulos (instancing)") << endl;
+    }
+    if (key == GLFW_KEY_W && action == GLFW_PRESS)
+    {
+        swarmMode = !swarmMode;
+        if (swarmMode)
+        {
+            startSwarm();
+        }
+        cout << "Enxame: " << (swarmMode ? "ligado" : "desligado") << endl;
+    }
+    if (key == GLFW_KEY_R && action == GLFW_PRESS)
+    {
+        if (cursor.setRawMotion(window, !cursor.rawMotion()))
+        {
+            cout << "Mouse: " << (cursor.rawMotion() ? "movimento bruto" : "cursor do sistema") << endl;
+        }
+        else
+        {
+            cout << "Mouse: movimento bruto nao suportado" << endl;
+        }
+    }
+    if (key == GLFW_KEY_M && action == GLFW_PRESS)
+    {
+        usePathHistory = !usePathHistory;
+        if (usePathHistory)
+        {
+            // Recomeça o caminho da posição atual, seguindo o segmento seguinte à cabeça
+            vec3 back = chain.size() > 1 ? vec3(chain.x[0] - chain.x[1], chain.y[0] - chain.y[1], 0.0) : dir;
+            back = length(back) > 0.0f ? normalize(back) : dir;
+            path.reset(chain.x[0], chain.y[0], back.x, back.y, segmentSpacing * chain.size());
+        }
+        cout << "Modo: " << (usePathHistory ? "historico do caminho" : "solver da corrente") << endl;
+    }
 
     if (action == GLFW_PRESS)
         keys[key] = true;
@@ -208,141 +464,194 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 }
 
 
+// Callback de posição do cursor: grava cada movimento
+void cursor_callback(GLFWwindow *window, double xpos, double ypos) {
+    cursor.push(xpos, ypos);
+}
+
 // Configura e compila os shaders
-int setupShader() {
-    // Código do vertex shader
-    const GLchar *vertexShaderSource = R"(
-    #version 400
-    layout (location = 0) in vec3 position;
-    uniform mat4 projection;
-    uniform mat4 model;
-    void main() {
-        gl_Position = projection * model * vec4(position, 1.0);
-    })";
-
-    // Código do fragment shader
-    const GLchar *fragmentShaderSource = R"(
-    #version 400
-    uniform vec4 inputColor;
-    out vec4 color;
-    void main() {
-        color = inputColor;
-    })";
-
-    // Compilação do vertex shader
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    // Verificando erros de compilação do vertex shader
-    GLint success;
-    GLchar infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+ShaderFuture setupShader() {
+    // Variante do shader de sprite com cor por vértice (fita do corpo e lotes de trechos)
+    // Submete o programa à biblioteca de shaders sem esperar a compilação terminar
+    return spriteShaders.request(ShaderVariants::VERTEX_COLOR);
+}
+
+// Cria o buffer de instâncias (na primeira chamada) e um VAO próprio sobre os vértices da
+// malha, com os atributos 3 (posição) e 4 (cor) avançando uma vez por instância (divisor 1)
+// em vez de uma vez por vértice. O VAO da MeshLibrary não é alterado
+GLuint createInstancedVAO(const Mesh& mesh)
+{
+    if (instanceVBO == 0)
+    {
+        glGenBuffers(1, &instanceVBO);
     }
+    GLuint VAO;
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+
+    // Vértices da malha (atributo 0, x, y), lidos do VBO da MeshLibrary
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid*)0);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(SegmentInstance), (GLvoid*)offsetof(SegmentInstance, offset));
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(SegmentInstance), (GLvoid*)offsetof(SegmentInstance, color));
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
 
-    // Compilação do fragment shader
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    // Verificando erros de compilação do fragment shader
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    return VAO;
+}
+
+// Desenha todos os segmentos com glDrawArraysInstanced
+void drawBody(GLuint shaderID)
+{
+    // Da cauda para a cabeça: as instâncias são desenhadas em ordem, a cabeça fica por cima
+    FrameVector<SegmentInstance> instances = frameVector<SegmentInstance>(frameArena, chain.size());
+    instances.resize(chain.size());
+    for (int i = chain.size() - 1, j = 0; i >= 0; i--, j++)
+    {
+        instances[j].offset = vec3(chain.x[i], chain.y[i], 0.0);
+        instances[j].color = vec4(segmentColor(i), 1.0);
     }
 
-    // Linkando os shaders no programa
-    GLuint shaderID = glCreateProgram();
-    glAttachShader(shaderID, vertexShader);
-    glAttachShader(shaderID, fragmentShader);
-    glLinkProgram(shaderID);
-    // Verificando erros de linkagem do programa de shaders
-    glGetProgramiv(shaderID, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderID, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+    drawInstances(shaderID, bodyMesh, body.dimensions, instances);
+}
+
+// Desenha o enxame inteiro em um draw instanciado. As instâncias são preenchidas em paralelo,
+// cada bloco de cobrinhas no seu trecho do buffer, da cauda para a cabeça
+void drawSwarm(GLuint shaderID)
+{
+    size_t length = swarm.length();
+    FrameVector<SegmentInstance> instances = frameVector<SegmentInstance>(frameArena, swarm.segments());
+    instances.resize(swarm.segments());
+    workers.parallelFor(swarm.snakes(), 256, [&](size_t begin, size_t end)
+    {
+        for (size_t s = begin; s < end; s++)
+        {
+            // Cor por cobrinha, com a cabeça mais clara
+            vec4 color = vec4(0.3f + 0.7f * ((s * 37) % 100) / 100.0f, 0.3f + 0.7f * ((s * 61) % 100) / 100.0f, 0.6f, 1.0f);
+            for (size_t i = 0; i < length; i++)
+            {
+                size_t k = s * length + i;
+                SegmentInstance& instance = instances[s * length + length - 1 - i];
+                instance.offset = vec3(swarm.x[k], swarm.y[k], 0.0);
+                instance.color = i == 0 ? vec4(1.0f) : color;
+            }
+        }
+    });
+
+    drawInstances(shaderID, swarmMesh, SWARM_DIMENSIONS, instances);
+}
+
+// Envia as instâncias e desenha a malha, com tamanho dimensions, uma vez por instância. O buffer
+// de instâncias só é realocado quando passa da capacidade atual (que então dobra)
+void drawInstances(GLuint shaderID, const Mesh& mesh, vec3 dimensions, const FrameVector<SegmentInstance>& instances)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    if (instances.size() > instanceCapacity)
+    {
+        instanceCapacity = std::max(instances.size(), 2 * instanceCapacity);
     }
+    // Mesmo sem crescer, o buffer é realocado (orphaning): o driver entrega memória nova e
+    // não precisa esperar o frame anterior, que ainda pode estar lendo o conteúdo antigo
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(SegmentInstance), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(SegmentInstance), instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    // Limpando os shaders compilados após o link
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    // Todos os segmentos têm o mesmo tamanho: a escala vai na matriz de modelo e a posição
+    // de cada um vem do atributo de instância
+    mat4 model = scale(mat4(1.0f), dimensions);
+    glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+    glUniform4f(glGetUniformLocation(shaderID, "inputColor"), 1.0f, 1.0f, 1.0f, 1.0f);
 
-    return shaderID;
+    glBindVertexArray(mesh.VAO);
+    glDrawArraysInstanced(mesh.mode, mesh.first, mesh.count, (GLsizei)instances.size());
+    glBindVertexArray(0);
 }
 
-// Função para desenhar o objeto
-void drawGeometry(GLuint shaderID, GLuint VAO, int nVertices, vec3 position, vec3 dimensions, float angle, vec3 color, GLuint drawingMode, int offset, vec3 axis) {
-    glBindVertexArray(VAO); // Vincula o VAO
+// Desenha um lote de trechos com uma única transformação; as cores vêm dos vértices
+void drawBatch(GLuint shaderID, DrawBatch& batch, const mat4& model) {
+    glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+    glUniform4f(glGetUniformLocation(shaderID, "inputColor"), 1.0f, 1.0f, 1.0f, 1.0f);
 
-    // Aplica as transformações de translação, rotação e escala
-    mat4 model = mat4(1.0f);
-    model = translate(model, position);
-    model = rotate(model, angle, axis);
-    model = scale(model, dimensions);
+    batch.draw();
+}
 
-    // Envia a matriz de modelo ao shader
+// Desenha o corpo como uma fita que passa pelo centro dos segmentos, com a largura dos
+// círculos e uma faixa de cor por segmento. A malha é refeita a cada frame
+void drawBodyRibbon(GLuint shaderID)
+{
+    ribbon.build(chain.x.data(), chain.y.data(), chain.size(), 0.5f * body.dimensions.x, segmentColor);
+
+    // Os vértices já estão em pixels e trazem a cor
+    mat4 model = mat4(1.0f);
     glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-    
-    // Envia a cor do objeto ao shader
-    glUniform4f(glGetUniformLocation(shaderID, "inputColor"), color.r, color.g, color.b, 1.0f);
+    glUniform4f(glGetUniformLocation(shaderID, "inputColor"), 1.0f, 1.0f, 1.0f, 1.0f);
 
-    // Desenha o objeto
-    glDrawArrays(drawingMode, offset, nVertices);
+    ribbon.draw();
+}
 
-    // Desvincula o VAO
-    glBindVertexArray(0);
+// Cria (ou recria) o enxame espalhado pela janela
+void startSwarm()
+{
+    swarm.init(swarmSnakes, SWARM_LENGTH, WIDTH, HEIGHT);
+    cout << "Enxame: " << swarm.snakes() << " cobrinhas de " << swarm.length() << " segmentos" << endl;
 }
 
-Geometry createSegment(int i, vec3 dir)
+// Acrescenta um segmento na cauda. Só a posição é guardada (na corrente): malha, tamanho e
+// cor são os mesmos para todos. No modo de histórico do caminho a posição é recalculada
+// já no próximo frame; no modo de solver ela é o ponto de partida do novo segmento
+void addSegment(vec3 dir)
 {
+    int i = chain.size();
     cout << "criando segmento " << i << endl;
 
-    // inicializa objeto Geometry para armazenar as informações do segmento
-    Geometry segment;
-    segment.VAO = createCircle(32, 0.5);
-    segment.nVertices = 34;
-
+    vec3 position;
     // posição inicial do segmento
     if (i == 0) // cabeça
     {
-        segment.position = vec3(400, 300, 0.0); // posição inicial no centro da tela
+        position = vec3(400, 300, 0.0); // posição inicial no centro da tela
     }
     else
     {
         // Ajusta a direção com base na posição dos segmentos anteriores para evitar sobreposição
-        if (i <= 2)
+        // (só a partir do segundo segmento depois da cabeça, quando há dois anteriores)
+        if (i == 2)
         {
-            dir = normalize(cobrinha[i - 1].position - cobrinha[i - 2].position);
+            dir = normalize(vec3(chain.x[i - 1] - chain.x[i - 2], chain.y[i - 1] - chain.y[i - 2], 0.0));
         }
         // Posiciona o novo segmento a uma distância mínima do anterior
-        segment.position = cobrinha[i - 1].position + minDistance * dir;
+        position = vec3(chain.x[i - 1], chain.y[i - 1], 0.0) + minDistance * dir;
     }
+    chain.push(position.x, position.y);
+}
 
-    // Define as dimensões do segmento (tamanho do círculo)
-    segment.dimensions = vec3(50, 50, 1.0);
-    segment.angle = 0.0;
-
-    // Alterna a cor do segmento entre azul e amarelo, dependendo do índice
-    if (i % 2 == 0)
-    {
-        segment.color = vec3(0.0, 0.0, 1.0);
-    }
-    else
-    {
-        segment.color = vec3(1.0, 1.0, 0.0);
-    }
+// Cores dos segmentos, alternando entre azul e amarelo pelo índice (tabela montada na
+// compilação; o período é o tamanho da tabela)
+constexpr Palette::Table<Palette::Color, 2> SEGMENT_COLORS = Palette::generate<Palette::Color, 2>([](size_t i) {
+    return i % 2 == 0 ? Palette::rgb(0.0f, 0.0f, 1.0f) : Palette::rgb(1.0f, 1.0f, 0.0f);
+});
 
-    return segment;
+vec3 segmentColor(int i)
+{
+    return Palette::toVec3(SEGMENT_COLORS[i % SEGMENT_COLORS.size()]);
 }
 
 int createEyes(int nPoints, float radius)
 {
-    vector<GLfloat> vertices;
+    // 4 leques (centro + nPoints + 1 pontos da borda), com x, y por vértice, gerados direto
+    // no vetor já dimensionado
+    int fanVertices = nPoints + 2;
+    vector<GLfloat> vertices(4 * 2 * fanVertices);
 
-    // ângulo inicial e incremento para cada ponto do círculo
-    float angle = 0.0;
+    // incremento para cada ponto do círculo
     float slice = 2 * Pi / static_cast<float>(nPoints);
 
     // Posições iniciais para os círculos dos olhos
@@ -350,84 +659,16 @@ int createEyes(int nPoints, float radius)
     float yi = 0.3f;   // Posição inicial Y das escleras
     radius = 0.225f;   // Raio das escleras
 
-    // Olho esquerdo (esclera)
-    vertices.push_back(xi);
-    vertices.push_back(yi);
-    vertices.push_back(0.0f);
-
-    for (int i = 0; i < nPoints + 1; i++)
-    {
-        float x = xi + radius * cos(angle);
-        float y = yi + radius * sin(angle);
-        float z = 0.0f;
-
-        vertices.push_back(x);
-        vertices.push_back(y);
-        vertices.push_back(z);
-
-        angle += slice; // Incrementa o ângulo para o próximo ponto
-    }
-
-    // Olho direito (esclera)
-    vertices.push_back(xi);
-    vertices.push_back(-yi);
-    vertices.push_back(0.0f);
-
-    for (int i = 0; i < nPoints + 1; i++)
-    {
-        float x = xi + radius * cos(angle);
-        float y = -yi + radius * sin(angle);
-        float z = 0.0f;
-
-        vertices.push_back(x);
-        vertices.push_back(y);
-        vertices.push_back(z);
-
-        angle += slice; // Incrementa o ângulo para o próximo ponto
-    }
-
-    // Olho esquerdo (pupila)
-    radius = 0.18f;
-    xi += 0.09f;
-    angle = 0.0;
-
-    vertices.push_back(xi);
-    vertices.push_back(yi);
-    vertices.push_back(0.0f);
-
-    for (int i = 0; i < nPoints + 1; i++) 
+    // Escleras (a direita continua o ângulo de onde a esquerda parou) e pupilas
+    float centers[4][2] = { { xi, yi }, { xi, -yi }, { xi + 0.09f, yi }, { xi + 0.18f, -yi } };
+    float radii[4] = { radius, radius, 0.18f, 0.18f };
+    float startAngles[4] = { 0.0f, (nPoints + 1) * slice, 0.0f, 0.0f };
+    for (int eye = 0; eye < 4; eye++)
     {
-        float x = xi + radius * cos(angle);
-        float y = yi + radius * sin(angle);
-        float z = 0.0f;
-
-        vertices.push_back(x);
-        vertices.push_back(y);
-        vertices.push_back(z);
-
-        angle += slice;
-    }
-
-    // Olho direito (pupila)
-    radius = 0.18f;
-    xi += 0.09f;
-    angle = 0.0;
-
-    vertices.push_back(xi);
-    vertices.push_back(-yi);
-    vertices.push_back(0.0f);
-
-    for (int i = 0; i < nPoints + 1; i++) 
-    {
-        float x = xi + radius * cos(angle);
-        float y = -yi + radius * sin(angle);
-        float z = 0.0f;
-
-        vertices.push_back(x);
-        vertices.push_back(y);
-        vertices.push_back(z);
-
-        angle += slice;
+        GLfloat* fan = vertices.data() + eye * 2 * fanVertices;
+        fan[0] = centers[eye][0];
+        fan[1] = centers[eye][1];
+        MeshLibrary::generateSpiral(fan + 2, nPoints + 1, centers[eye][0], centers[eye][1], radii[eye], 0.0f, startAngles[eye], slice);
     }
 
     // Identificadores para o VBO e VAO
@@ -444,7 +685,7 @@ int createEyes(int nPoints, float radius)
     glBindVertexArray(VAO);
 
     // Configuração do ponteiro de atributos para os vértices
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid*)0);
     glEnableVertexAttribArray(0);
 
     // Desvincula o VBO e o VAO para evitar modificações acidentais
@@ -454,45 +695,3 @@ int createEyes(int nPoints, float radius)
     // Retorna o identificador do VAO, que será utilizado para desenhar os olhos
     return VAO;
 }
-
-int createCircle(int nPoints, float radius, float xc, float yc)
-{
-    vector<GLfloat> vertices;
-
-    float angle = 0.0;
-    float slice = 2 * Pi / static_cast<float>(nPoints);
-
-    vertices.push_back(xc);
-    vertices.push_back(yc);
-    vertices.push_back(0.0);
-
-    for (int i = 0; i < nPoints + 1; i++)
-    {
-        float x = xc + radius * cos(angle);
-        float y = yc + radius * sin(angle);
-        float z = 0.0f;
-
-        vertices.push_back(x);
-        vertices.push_back(y);
-        vertices.push_back(z);
-
-        angle += slice;
-    }
-
-    GLuint VBO, VAO;
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
-
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
-    glEnableVertexAttribArray(0);
-
-    // Desvincula o VAO e o VBO
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-
-    return VAO;
-}
@@ -0,0 +1,271 @@
+// Restrição de corrente "segue o líder" para os segmentos da cobrinha
+// As posições ficam em arrays separados (SoA: x[] e y[]), com o líder (cabeça) no índice 0.
+// A cada passo, cada segmento i se aproxima (ou se afasta) de i - 1 até a distância entre
+// eles voltar para [minDistance, maxDistance], com o mesmo amortecimento do laço original:
+//
+//   d = p[i-1] - p[i],  dist = |d|
+//   alvo = p[i] + (dist - clamp(dist, min, max)) * d / dist
+//   p[i] = mix(p[i], alvo, smoothFactor * dist / maxDistance)
+//
+// que se simplifica para p[i] += (smoothFactor / maxDistance) * (dist - clamp(dist, min, max)) * d,
+// com uma única raiz (dist = d2 * rsqrt(d2)) e sem divisão.
+// Para processar vários segmentos por iteração, todos leem a posição do antecessor do
+// início do passo (atualização de Jacobi): o laço anda da cauda para a cabeça, então o
+// antecessor ainda não foi escrito quando é lido. Cada elo responde ao movimento do anterior
+// com um passo de atraso, o que o amortecimento já esconde.
+// Versões escalar, SSE2 (4 segmentos) e AVX (8 segmentos), escolhidas em tempo de execução.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHAINSOLVER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace ChainSolver
+{
+	// Conjunto de instruções usado pelos kernels
+	enum Isa { SCALAR, SSE2, AVX };
+
+	inline const char* isaName(Isa isa)
+	{
+		switch (isa)
+		{
+		case SSE2: return "SSE2";
+		case AVX: return "AVX";
+		default: return "escalar";
+		}
+	}
+
+	inline Isa detectIsa()
+	{
+#ifdef CHAINSOLVER_X86
+		static const Isa isa = []()
+		{
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx")) return AVX;
+			if (__builtin_cpu_supports("sse2")) return SSE2;
+			return SCALAR;
+		}();
+		return isa;
+#else
+		return SCALAR;
+#endif
+	}
+
+	struct Params
+	{
+		float smoothFactor;
+		float minDistance;
+		float maxDistance;
+	};
+
+	// Posições dos segmentos em SoA; o índice 0 é o líder
+	struct Chain
+	{
+		std::vector<float> x, y;
+
+		size_t size() const { return x.size(); }
+
+		void push(float px, float py)
+		{
+			x.push_back(px);
+			y.push_back(py);
+		}
+
+		void resize(size_t n)
+		{
+			x.resize(n);
+			y.resize(n);
+		}
+	};
+
+	// Evita 0 * inf quando dois segmentos coincidem (dist = 0, nada a corrigir)
+	const float MIN_DIST2 = 1e-12f;
+
+	// ------------------------------------------------------------------------
+	// Versão escalar (também trata o "resto" dos laços SIMD): segmentos [1, end), da cauda
+	// para a cabeça
+
+	inline void solveScalar(float* x, float* y, size_t end, const Params& p)
+	{
+		const float k = p.smoothFactor / p.maxDistance;
+		for (size_t i = end; i-- > 1;)
+		{
+			float dx = x[i - 1] - x[i];
+			float dy = y[i - 1] - y[i];
+			float dist = std::sqrt(dx * dx + dy * dy);
+			float excess = dist - std::min(std::max(dist, p.minDistance), p.maxDistance);
+			x[i] += k * excess * dx;
+			y[i] += k * excess * dy;
+		}
+	}
+
+#ifdef CHAINSOLVER_X86
+	// ------------------------------------------------------------------------
+	// SSE2: 4 segmentos por iteração
+
+	__attribute__((target("sse2")))
+	inline void solveSSE2(float* x, float* y, size_t n, const Params& p)
+	{
+		const __m128 k = _mm_set1_ps(p.smoothFactor / p.maxDistance);
+		const __m128 minD = _mm_set1_ps(p.minDistance);
+		const __m128 maxD = _mm_set1_ps(p.maxDistance);
+		const __m128 eps = _mm_set1_ps(MIN_DIST2);
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 threeHalves = _mm_set1_ps(1.5f);
+
+		// Blocos [i, i + 4) da cauda para a cabeça; o bloco lê [i - 1, i + 3)
+		size_t i = n;
+		while (i >= 5)
+		{
+			i -= 4;
+			__m128 xi = _mm_loadu_ps(x + i), yi = _mm_loadu_ps(y + i);
+			__m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i - 1), xi);
+			__m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i - 1), yi);
+			__m128 d2 = _mm_max_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), eps);
+			// rsqrt aproximado (12 bits) + uma iteração de Newton-Raphson
+			__m128 r = _mm_rsqrt_ps(d2);
+			r = _mm_mul_ps(r, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, d2), _mm_mul_ps(r, r))));
+			__m128 dist = _mm_mul_ps(d2, r);
+			__m128 excess = _mm_sub_ps(dist, _mm_min_ps(_mm_max_ps(dist, minD), maxD));
+			__m128 f = _mm_mul_ps(k, excess);
+			_mm_storeu_ps(x + i, _mm_add_ps(xi, _mm_mul_ps(f, dx)));
+			_mm_storeu_ps(y + i, _mm_add_ps(yi, _mm_mul_ps(f, dy)));
+		}
+		solveScalar(x, y, i, p);
+	}
+
+	// ------------------------------------------------------------------------
+	// AVX: 8 segmentos por iteração
+
+	__attribute__((target("avx")))
+	inline void solveAVX(float* x, float* y, size_t n, const Params& p)
+	{
+		const __m256 k = _mm256_set1_ps(p.smoothFactor / p.maxDistance);
+		const __m256 minD = _mm256_set1_ps(p.minDistance);
+		const __m256 maxD = _mm256_set1_ps(p.maxDistance);
+		const __m256 eps = _mm256_set1_ps(MIN_DIST2);
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 threeHalves = _mm256_set1_ps(1.5f);
+
+		size_t i = n;
+		while (i >= 9)
+		{
+			i -= 8;
+			__m256 xi = _mm256_loadu_ps(x + i), yi = _mm256_loadu_ps(y + i);
+			__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i - 1), xi);
+			__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i - 1), yi);
+			__m256 d2 = _mm256_max_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), eps);
+			__m256 r = _mm256_rsqrt_ps(d2);
+			r = _mm256_mul_ps(r, _mm256_sub_ps(threeHalves, _mm256_mul_ps(_mm256_mul_ps(half, d2), _mm256_mul_ps(r, r))));
+			__m256 dist = _mm256_mul_ps(d2, r);
+			__m256 excess = _mm256_sub_ps(dist, _mm256_min_ps(_mm256_max_ps(dist, minD), maxD));
+			__m256 f = _mm256_mul_ps(k, excess);
+			_mm256_storeu_ps(x + i, _mm256_add_ps(xi, _mm256_mul_ps(f, dx)));
+			_mm256_storeu_ps(y + i, _mm256_add_ps(yi, _mm256_mul_ps(f, dy)));
+		}
+		solveScalar(x, y, i, p);
+	}
+#endif
+
+	// ------------------------------------------------------------------------
+	// Um passo do solver: move os segmentos 1..n-1 (o líder já deve estar na posição nova)
+
+	inline void solve(float* x, float* y, size_t n, const Params& p, Isa isa = detectIsa())
+	{
+#ifdef CHAINSOLVER_X86
+		if (isa >= AVX) { solveAVX(x, y, n, p); return; }
+		if (isa >= SSE2) { solveSSE2(x, y, n, p); return; }
+#endif
+		solveScalar(x, y, n, p);
+	}
+
+	inline void solve(Chain& chain, const Params& p, Isa isa = detectIsa())
+	{
+		solve(chain.x.data(), chain.y.data(), chain.size(), p, isa);
+	}
+
+	// ------------------------------------------------------------------------
+	// Benchmark (FollowMouse.exe --bench): laço original (AoS, normalize + length + mix,
+	// segmento a segmento) contra o solver, em ns por segmento
+
+	inline void benchmark()
+	{
+		// Registro como o Geometry do programa: posição junto com VAO, cor etc.
+		struct Segment
+		{
+			unsigned VAO;
+			float position[3];
+			float angle;
+			float dimensions[3];
+			float color[3];
+			int nVertices;
+		};
+
+		const Params p = { 0.1f, 0.05f, 0.1f };
+		std::cout << "ChainSolver: ns por segmento por passo" << std::endl;
+		for (size_t n : { (size_t)100, (size_t)10000, (size_t)1000000 })
+		{
+			// Corrente em zigue-zague, com elos fora do intervalo [min, max]
+			std::vector<Segment> segments(n);
+			Chain chain;
+			chain.resize(n);
+			for (size_t i = 0; i < n; i++)
+			{
+				float px = i * 0.08f, py = (i % 2) * 0.07f + (rand() % 100) * 1e-4f;
+				segments[i] = Segment{ 0, { px, py, 0.0f }, 0.0f, { 50, 50, 1 }, { 0, 0, 1 }, 34 };
+				chain.x[i] = px;
+				chain.y[i] = py;
+			}
+			int steps = (int)std::max((size_t)10, (size_t)20000000 / n);
+
+			auto start = std::chrono::steady_clock::now();
+			for (int s = 0; s < steps; s++)
+			{
+				for (size_t i = 1; i < n; i++)
+				{
+					float* a = segments[i - 1].position;
+					float* b = segments[i].position;
+					float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+					// normalize() e length() da mesma diferença: duas raízes
+					float inv = 1.0f / std::sqrt(dx * dx + dy * dy + dz * dz);
+					float dir[3] = { dx * inv, dy * inv, dz * inv };
+					float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+					float target[3] = { b[0], b[1], b[2] };
+					float factor = p.smoothFactor * (distance / p.maxDistance);
+					float excess = distance < p.minDistance ? distance - p.minDistance
+						: distance > p.maxDistance ? distance - p.maxDistance : 0.0f;
+					for (int c = 0; c < 3; c++)
+					{
+						target[c] += excess * dir[c];
+						b[c] = b[c] * (1.0f - factor) + target[c] * factor; // mix()
+					}
+				}
+			}
+			double legacy = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			std::cout << "  " << n << " segmentos: original " << legacy / steps / n * 1.0e9;
+			for (Isa isa : { SCALAR, detectIsa() })
+			{
+				Chain work = chain;
+				start = std::chrono::steady_clock::now();
+				for (int s = 0; s < steps; s++)
+				{
+					solve(work, p, isa);
+				}
+				double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				std::cout << ", " << isaName(isa) << " " << seconds / steps / n * 1.0e9;
+			}
+			std::cout << std::endl;
+		}
+	}
+}
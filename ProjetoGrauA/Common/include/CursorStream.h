@@ -0,0 +1,95 @@
+// Fluxo de eventos de movimento do mouse
+// Em vez de ler glfwGetCursorPos uma vez por frame, o callback de posição do cursor grava
+// cada evento (posição em coordenadas da janela e instante) e o frame consome todos os que
+// chegaram desde o anterior (drain), na ordem. Um movimento rápido entre dois frames vira
+// vários pontos, e não só o ponto final.
+// Com o movimento bruto (GLFW_RAW_MOUSE_MOTION, quando o sistema oferece) o cursor fica
+// escondido e preso na janela, e o GLFW entrega uma posição virtual sem aceleração do
+// sistema; o fluxo acumula as diferenças numa posição própria, limitada à janela.
+// Os instantes são os do callback: o GLFW entrega os eventos dentro de glfwPollEvents, então
+// eventos do mesmo frame podem ter instantes quase iguais. A ordem e as posições é que
+// importam para reconstruir o caminho.
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+class CursorStream
+{
+public:
+	struct Sample
+	{
+		float x, y;  // coordenadas da janela (y para baixo)
+		double time; // glfwGetTime() no callback
+	};
+
+	// Posição inicial e tamanho da janela (limites da posição no modo bruto)
+	void init(GLFWwindow* window)
+	{
+		int width, height;
+		glfwGetWindowSize(window, &width, &height);
+		windowWidth = (float)width;
+		windowHeight = (float)height;
+		double x, y;
+		glfwGetCursorPos(window, &x, &y);
+		latest = Sample{ (float)x, (float)y, glfwGetTime() };
+		events.reserve(256);
+	}
+
+	// Liga ou desliga o movimento bruto. Retorna false se o sistema não oferece
+	bool setRawMotion(GLFWwindow* window, bool enable)
+	{
+		if (enable && !glfwRawMouseMotionSupported())
+		{
+			return false;
+		}
+		glfwSetInputMode(window, GLFW_CURSOR, enable ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+		glfwSetInputMode(window, GLFW_RAW_MOUSE_MOTION, enable ? GLFW_TRUE : GLFW_FALSE);
+		raw = enable;
+		double x, y;
+		glfwGetCursorPos(window, &x, &y);
+		lastRawX = x;
+		lastRawY = y;
+		return true;
+	}
+
+	bool rawMotion() const { return raw; }
+
+	// Chamado pelo callback de posição do cursor
+	void push(double x, double y)
+	{
+		if (raw)
+		{
+			// Posição virtual: só a diferença interessa
+			float px = latest.x + (float)(x - lastRawX);
+			float py = latest.y + (float)(y - lastRawY);
+			lastRawX = x;
+			lastRawY = y;
+			x = std::min(std::max(px, 0.0f), windowWidth);
+			y = std::min(std::max(py, 0.0f), windowHeight);
+		}
+		latest = Sample{ (float)x, (float)y, glfwGetTime() };
+		events.push_back(latest);
+	}
+
+	// Move para out os eventos desde a última chamada (out fica vazio se o mouse não mexeu)
+	void drain(std::vector<Sample>& out)
+	{
+		out.swap(events);
+		events.clear();
+	}
+
+	// Último evento recebido (ou a posição inicial)
+	const Sample& last() const { return latest; }
+
+private:
+	std::vector<Sample> events;
+	Sample latest = { 0.0f, 0.0f, 0.0 };
+	bool raw = false;
+	double lastRawX = 0.0, lastRawY = 0.0;
+	float windowWidth = 0.0f, windowHeight = 0.0f;
+};
@@ -0,0 +1,144 @@
+// Lote de desenho de trechos (first, count) de um mesmo VAO
+// Em vez de um glDrawArrays por trecho, com a cor enviada por uniform entre eles, cada
+// trecho leva a sua cor num atributo de vértice (um VBO de cores ligado ao VAO, atributo 2
+// por padrão, o vertexColor da variante VERTEX_COLOR). Sem a troca de uniform, trechos
+// seguidos com o mesmo modo de desenho viram um único glMultiDrawArrays.
+// A ordem dos trechos é mantida (o que vem depois desenha por cima); só trechos vizinhos
+// são juntados. As cores são gravadas por vértice, então dois trechos que compartilham
+// vértices precisam ter a mesma cor (senão vale a do último, com uma mensagem de erro).
+
+#pragma once
+
+#include <vector>
+#include <iostream>
+
+//GLAD
+#include <glad/glad.h>
+
+//GLM
+#include <glm/glm.hpp>
+
+class DrawBatch
+{
+public:
+	// Liga um buffer de cores ao VAO, que tem nVertices vértices no total
+	void init(GLuint vao, GLsizei nVertices, GLuint colorAttribute = 2)
+	{
+		VAO = vao;
+		vertexCount = nVertices;
+		colors.assign(nVertices, glm::vec4(1.0f));
+
+		glGenBuffers(1, &colorVBO);
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, colorVBO);
+		glBufferData(GL_ARRAY_BUFFER, nVertices * sizeof(glm::vec4), colors.data(), GL_STATIC_DRAW);
+		glVertexAttribPointer(colorAttribute, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (GLvoid*)0);
+		glEnableVertexAttribArray(colorAttribute);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+	// Acrescenta o trecho [first, first + count), desenhado com mode e com a cor color
+	void add(GLenum mode, GLint first, GLsizei count, glm::vec4 color)
+	{
+		if (first < 0 || count <= 0 || first + count > vertexCount)
+		{
+			std::cout << "ERROR::DRAWBATCH::RANGE_OUT_OF_BOUNDS " << first << " + " << count << std::endl;
+			return;
+		}
+		ranges.push_back(Range{ mode, first, count, color });
+		dirty = true;
+	}
+
+	void add(GLenum mode, GLint first, GLsizei count, glm::vec3 color)
+	{
+		add(mode, first, count, glm::vec4(color, 1.0f));
+	}
+
+	// Remove todos os trechos
+	void clear()
+	{
+		ranges.clear();
+		dirty = true;
+	}
+
+	// Desenha todos os trechos, na ordem em que foram acrescentados
+	void draw()
+	{
+		if (dirty)
+		{
+			rebuild();
+		}
+		glBindVertexArray(VAO);
+		for (const Group& group : groups)
+		{
+			glMultiDrawArrays(group.mode, group.firsts.data(), group.counts.data(), (GLsizei)group.firsts.size());
+		}
+		glBindVertexArray(0);
+	}
+
+	// Quantos draw calls draw() faz
+	int drawCalls()
+	{
+		if (dirty)
+		{
+			rebuild();
+		}
+		return (int)groups.size();
+	}
+
+private:
+	struct Range
+	{
+		GLenum mode;
+		GLint first;
+		GLsizei count;
+		glm::vec4 color;
+	};
+
+	// Trechos seguidos com o mesmo modo: um glMultiDrawArrays
+	struct Group
+	{
+		GLenum mode;
+		std::vector<GLint> firsts;
+		std::vector<GLsizei> counts;
+	};
+
+	GLuint VAO = 0, colorVBO = 0;
+	GLsizei vertexCount = 0;
+	std::vector<Range> ranges;
+	std::vector<Group> groups;
+	std::vector<glm::vec4> colors;
+	bool dirty = false;
+
+	// Grava as cores dos trechos no buffer e refaz os grupos
+	void rebuild()
+	{
+		std::vector<bool> written(vertexCount, false);
+		colors.assign(vertexCount, glm::vec4(1.0f));
+		groups.clear();
+		for (const Range& range : ranges)
+		{
+			for (GLint v = range.first; v < range.first + range.count; v++)
+			{
+				if (written[v] && colors[v] != range.color)
+				{
+					std::cout << "ERROR::DRAWBATCH::COLOR_CONFLICT vertice " << v << std::endl;
+				}
+				colors[v] = range.color;
+				written[v] = true;
+			}
+			if (groups.empty() || groups.back().mode != range.mode)
+			{
+				groups.push_back(Group{ range.mode, {}, {} });
+			}
+			groups.back().firsts.push_back(range.first);
+			groups.back().counts.push_back(range.count);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, colorVBO);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, vertexCount * sizeof(glm::vec4), colors.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		dirty = false;
+	}
+};
@@ -0,0 +1,143 @@
+// Memória temporária de um frame (arena linear)
+// Dados que só vivem durante o frame (vértices de lotes, tesselações, listas de comandos,
+// chaves de ordenação) saem de um bloco único: alocar é só avançar um ponteiro, e liberar
+// tudo é voltar o ponteiro para o início com reset() no fim do frame. Não há malloc nem free
+// por alocação.
+// Quando o bloco não basta, o excesso vem do heap (blocos avulsos, liberados no reset) e o
+// reset aumenta o bloco para o pico daquele frame, então no frame seguinte tudo volta a caber.
+// peak() e growths() dizem quanto a arena precisou, para escolher a capacidade inicial.
+// ArenaAllocator liga containers da STL à arena (FrameVector). deallocate só devolve memória
+// quando é a última alocação (o caso de um vector que cresce sem outras alocações no meio);
+// fora isso a memória fica presa até o reset, então vale reservar o tamanho antes de encher.
+// Uma arena não é compartilhada entre threads: a alocação não tem trava. Threads podem
+// escrever em memória já alocada (por exemplo, trechos separados de um FrameVector).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+class FrameArena
+{
+public:
+	explicit FrameArena(size_t capacity = 1 << 20)
+		: block(new unsigned char[capacity]), blockSize(capacity)
+	{
+	}
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// bytes com o alinhamento pedido (potência de 2)
+	void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+	{
+		uintptr_t base = (uintptr_t)block.get();
+		uintptr_t start = (base + top + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		if (start + bytes <= base + blockSize)
+		{
+			top = start + bytes - base;
+			return (void*)start;
+		}
+
+		// Não coube: bloco avulso, liberado no reset
+		overflow.emplace_back(new unsigned char[bytes + alignment]);
+		overflowBytes += bytes + alignment;
+		uintptr_t extra = (uintptr_t)overflow.back().get();
+		return (void*)((extra + alignment - 1) & ~(uintptr_t)(alignment - 1));
+	}
+
+	// Espaço para count objetos de T (não construídos)
+	template <class T>
+	T* allocateArray(size_t count)
+	{
+		return (T*)allocate(count * sizeof(T), alignof(T));
+	}
+
+	// Devolve a última alocação do bloco (qualquer outra fica até o reset)
+	void release(void* pointer, size_t bytes)
+	{
+		uintptr_t base = (uintptr_t)block.get();
+		uintptr_t p = (uintptr_t)pointer;
+		if (p >= base && p + bytes == base + top)
+		{
+			top = p - base;
+		}
+	}
+
+	// Fim do frame: tudo o que foi alocado deixa de valer
+	void reset()
+	{
+		lastFrame = top + overflowBytes;
+		framePeak = std::max(framePeak, lastFrame);
+		if (!overflow.empty())
+		{
+			// Cresce para o pico deste frame, com folga para o próximo
+			overflow.clear();
+			blockSize = std::max(2 * blockSize, lastFrame + lastFrame / 2);
+			block.reset(new unsigned char[blockSize]);
+			grown++;
+		}
+		overflowBytes = 0;
+		top = 0;
+	}
+
+	size_t used() const { return top + overflowBytes; }  // bytes alocados neste frame
+	size_t capacity() const { return blockSize; }        // tamanho do bloco
+	size_t lastFrameBytes() const { return lastFrame; }  // bytes do último frame encerrado
+	size_t peak() const { return framePeak; }            // maior frame até agora
+	int growths() const { return grown; }                // vezes em que o bloco aumentou
+
+private:
+	std::unique_ptr<unsigned char[]> block;
+	size_t blockSize;
+	size_t top = 0;
+	std::vector<std::unique_ptr<unsigned char[]>> overflow;
+	size_t overflowBytes = 0;
+	size_t lastFrame = 0, framePeak = 0;
+	int grown = 0;
+};
+
+// Alocador de containers da STL sobre uma FrameArena
+template <class T>
+struct ArenaAllocator
+{
+	using value_type = T;
+
+	FrameArena* arena;
+
+	explicit ArenaAllocator(FrameArena& arena) : arena(&arena) {}
+
+	template <class U>
+	ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+	T* allocate(size_t n)
+	{
+		return arena->allocateArray<T>(n);
+	}
+
+	void deallocate(T* pointer, size_t n)
+	{
+		arena->release(pointer, n * sizeof(T));
+	}
+
+	template <class U>
+	bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+	template <class U>
+	bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+// Vector com a memória na arena: só vale até o reset
+template <class T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+// FrameVector vazio com capacidade para reserve elementos
+template <class T>
+FrameVector<T> frameVector(FrameArena& arena, size_t reserve = 0)
+{
+	FrameVector<T> vector{ ArenaAllocator<T>(arena) };
+	vector.reserve(reserve);
+	return vector;
+}
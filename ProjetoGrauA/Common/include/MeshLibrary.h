@@ -0,0 +1,256 @@
+// Biblioteca de malhas procedurais (círculo, arco) e gerador de pontos de arcos e espirais
+// Cada malha é gerada e enviada para a GPU uma vez só, e guardada pelo tipo e pelos
+// parâmetros: quem pede a mesma malha recebe o mesmo VAO. Todas as malhas têm só o atributo
+// 0, com x, y em float (o z = 0 vem do padrão do atributo, sem gastar 4 bytes por vértice),
+// e são desenhadas com glDrawArrays(mesh.mode, mesh.first, mesh.count).
+// O VAO é compartilhado por todos que pedem a malha e não deve ser alterado; quem precisa de
+// outros atributos (por exemplo, de instância) cria o seu próprio VAO sobre mesh.VBO.
+// O número de divisões de um círculo pode vir do tamanho dele na tela (circleForScreen):
+// a corda de cada divisão fica a menos de MAX_ERROR_PIXELS do círculo verdadeiro, arredondado
+// para potência de 2 entre MIN_SEGMENTS e MAX_SEGMENTS. Assim existem poucos níveis no cache
+// e círculos pequenos não pagam pela resolução dos grandes.
+// Os pontos são gerados sem sin/cos por ponto (generateSpiral): cada uma de LANES faixas
+// gira o seu ponto de LANES passos por iteração, com a matriz de rotação calculada uma vez;
+// a cada ANCHOR_POINTS pontos as faixas recomeçam de valores exatos, para o erro do float
+// não acumular. O ganho vem de trocar sin e cos por 4 multiplicações por ponto; as faixas
+// não dependem umas das outras, então um build otimizado pode ainda vetorizar o laço, mas
+// isso não é garantido (as builds de depuração, só com -g, não vetorizam). A escrita vai
+// direto para o ponteiro dado (um vector já dimensionado ou um buffer mapeado com
+// glMapBufferRange), então dá para gerar malhas densas a cada frame.
+
+#pragma once
+
+#include <cmath>
+#include <map>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+//GLAD
+#include <glad/glad.h>
+
+//GLM
+#include <glm/glm.hpp>
+
+struct Mesh
+{
+	GLuint VAO = 0;
+	GLuint VBO = 0;   // vértices (x, y em float), para montar outros VAOs sobre a malha
+	GLenum mode = GL_TRIANGLE_FAN;
+	GLint first = 0;
+	GLsizei count = 0;
+	int segments = 0; // divisões usadas na geração
+};
+
+class MeshLibrary
+{
+public:
+	static const int MIN_SEGMENTS = 8;
+	static const int MAX_SEGMENTS = 128;
+	static constexpr float MAX_ERROR_PIXELS = 0.5f;
+
+	// Instância única
+	static MeshLibrary& get()
+	{
+		static MeshLibrary library;
+		return library;
+	}
+
+	// Círculo (leque com o centro) de raio radius e segments divisões
+	const Mesh& circle(int segments, float radius = 0.5f)
+	{
+		return arc(segments, radius, 0.0f, segments + 1);
+	}
+
+	// Leque com o centro e steps pontos da borda, começando no ângulo startAngle (radianos) e
+	// avançando 2 * Pi / segments por ponto
+	const Mesh& arc(int segments, float radius, float startAngle, int steps)
+	{
+		Key key = { ARC, segments, steps, radius, startAngle, 0.0f };
+		auto it = meshes.find(key);
+		if (it != meshes.end())
+		{
+			return it->second;
+		}
+
+		std::vector<GLfloat> vertices(2 * (steps + 1));
+		vertices[0] = vertices[1] = 0.0f;
+		generateSpiral(vertices.data() + 2, steps, 0.0f, 0.0f, radius, 0.0f, startAngle, 2.0f * PI / (float)segments);
+		return store(key, vertices, GL_TRIANGLE_FAN, segments);
+	}
+
+	// Escreve count pontos (x, y) em dst: o ponto i fica no ângulo startAngle + i * step, a
+	// (radius + i * growth) de (xc, yc). Com growth = 0 é um arco de círculo
+	static void generateSpiral(GLfloat* dst, int count, float xc, float yc, float radius, float growth, float startAngle, float step)
+	{
+		// Rotação de LANES passos
+		const float stepCos = std::cos(LANES * step), stepSin = std::sin(LANES * step);
+		for (int base = 0; base < count; base += ANCHOR_POINTS)
+		{
+			int end = std::min(base + ANCHOR_POINTS, count);
+
+			// Valores exatos no início do bloco (ângulo em double: i * step perde precisão em
+			// float quando i é grande)
+			float c[LANES], sn[LANES];
+			for (int l = 0; l < LANES; l++)
+			{
+				double angle = startAngle + (double)(base + l) * step;
+				c[l] = (float)std::cos(angle);
+				sn[l] = (float)std::sin(angle);
+			}
+
+			int i = base;
+			for (; i + LANES <= end; i += LANES)
+			{
+				GLfloat* out = dst + 2 * i;
+				for (int l = 0; l < LANES; l++)
+				{
+					float r = radius + (i + l) * growth;
+					out[2 * l] = xc + r * c[l];
+					out[2 * l + 1] = yc + r * sn[l];
+					float rotatedCos = c[l] * stepCos - sn[l] * stepSin;
+					sn[l] = sn[l] * stepCos + c[l] * stepSin;
+					c[l] = rotatedCos;
+				}
+			}
+			// Resto do bloco (menos de LANES pontos)
+			for (int l = 0; i < end; i++, l++)
+			{
+				float r = radius + i * growth;
+				dst[2 * i] = xc + r * c[l];
+				dst[2 * i + 1] = yc + r * sn[l];
+			}
+		}
+	}
+
+	// Divisões para um círculo com screenRadius pixels de raio na tela
+	static int segmentsForRadius(float screenRadius)
+	{
+		if (!(screenRadius > MAX_ERROR_PIXELS))
+		{
+			return MIN_SEGMENTS;
+		}
+		// Distância máxima entre a corda e o arco: r * (1 - cos(Pi / n)) <= erro
+		float needed = PI / std::acos(1.0f - MAX_ERROR_PIXELS / screenRadius);
+		int segments = MIN_SEGMENTS;
+		while (segments < needed && segments < MAX_SEGMENTS)
+		{
+			segments *= 2;
+		}
+		return segments;
+	}
+
+	// Raio em pixels de um círculo de raio worldRadius, com a projeção e o viewport dados
+	// (projeção ortográfica ou sem rotação: usa a escala em x)
+	static float screenRadius(float worldRadius, const glm::mat4& projection, glm::vec2 viewport)
+	{
+		return worldRadius * 0.5f * std::fabs(projection[0][0]) * viewport.x;
+	}
+
+	// Círculo com as divisões escolhidas pelo tamanho na tela
+	const Mesh& circleForScreen(float screenRadius, float radius = 0.5f)
+	{
+		return circle(segmentsForRadius(screenRadius), radius);
+	}
+
+	// Quantas malhas estão no cache
+	int size() const
+	{
+		return (int)meshes.size();
+	}
+
+	// Benchmark: geração com sin/cos por ponto (push_back de cada float) contra generateSpiral,
+	// em ns por ponto, e o maior erro da recorrência
+	static void benchmark()
+	{
+		const int points = 100000;
+		const float step = 2.0f * PI / 1000.0f;
+		std::cout << "MeshLibrary: " << points << " pontos de espiral, ns por ponto" << std::endl;
+
+		const int repeats = 50;
+		std::vector<GLfloat> reference;
+		auto start = std::chrono::steady_clock::now();
+		for (int r = 0; r < repeats; r++)
+		{
+			reference.clear();
+			for (int i = 0; i < points; i++)
+			{
+				float radius = 1.0f + i * 0.001f;
+				reference.push_back(radius * std::cos(i * step));
+				reference.push_back(radius * std::sin(i * step));
+			}
+		}
+		double trig = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::vector<GLfloat> generated(2 * points);
+		start = std::chrono::steady_clock::now();
+		for (int r = 0; r < repeats; r++)
+		{
+			generateSpiral(generated.data(), points, 0.0f, 0.0f, 1.0f, 0.001f, 0.0f, step);
+		}
+		double recurrence = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		float maxError = 0.0f;
+		for (int i = 0; i < points; i++)
+		{
+			double angle = (double)i * step, radius = 1.0 + i * 0.001;
+			maxError = std::max(maxError, (float)std::fabs(generated[2 * i] - radius * std::cos(angle)));
+			maxError = std::max(maxError, (float)std::fabs(generated[2 * i + 1] - radius * std::sin(angle)));
+		}
+		std::cout << "  sin/cos " << trig / repeats / points * 1.0e9 << ", recorrencia "
+			<< recurrence / repeats / points * 1.0e9 << " (erro maximo " << maxError << " com raio ate "
+			<< 1.0f + points * 0.001f << ")" << std::endl;
+	}
+
+private:
+	static constexpr float PI = 3.14159265f;
+	static const int LANES = 8;           // pontos girados juntos, cada um com a sua recorrência
+	static const int ANCHOR_POINTS = 256; // pontos entre dois recomeços exatos
+
+	enum Type { ARC };
+
+	// Tipo e parâmetros (inteiros e reais) de uma malha
+	struct Key
+	{
+		Type type;
+		int i0, i1;
+		float f0, f1, f2;
+
+		bool operator<(const Key& other) const
+		{
+			if (type != other.type) return type < other.type;
+			if (i0 != other.i0) return i0 < other.i0;
+			if (i1 != other.i1) return i1 < other.i1;
+			if (f0 != other.f0) return f0 < other.f0;
+			if (f1 != other.f1) return f1 < other.f1;
+			return f2 < other.f2;
+		}
+	};
+
+	// std::map: as referências devolvidas continuam válidas quando outras malhas entram
+	std::map<Key, Mesh> meshes;
+
+	MeshLibrary() {}
+
+	const Mesh& store(const Key& key, const std::vector<GLfloat>& vertices, GLenum mode, int segments)
+	{
+		Mesh mesh;
+		mesh.mode = mode;
+		mesh.count = (GLsizei)(vertices.size() / 2);
+		mesh.segments = segments;
+
+		glGenBuffers(1, &mesh.VBO);
+		glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
+
+		glGenVertexArrays(1, &mesh.VAO);
+		glBindVertexArray(mesh.VAO);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid*)0);
+		glEnableVertexAttribArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+
+		return meshes[key] = mesh;
+	}
+};
@@ -0,0 +1,102 @@
+// Tabelas de cores e padrões geradas em tempo de compilação
+// Padrões de cor escritos como cadeias de if sobre índices (quadrado (i, j) da grade, segmento
+// i do corpo) viram funções constexpr; generate e generatePattern avaliam essas funções para
+// todos os índices na compilação e guardam o resultado numa tabela constexpr. Em tempo de
+// execução escolher a cor é só ler a tabela, sem nenhum desvio.
+// Um padrão 2D precisa repetir: se a função só usa i % a e j % b, ela repete a cada mmc dos
+// a em linhas e mmc dos b em colunas, e a tabela de ROWS x COLUMNS cobre qualquer (i, j).
+// isPeriodic confere isso na compilação (com static_assert) comparando dois períodos.
+// A função geradora pode ser uma função constexpr ou uma lambda (constexpr implícito).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+
+//GLM
+#include <glm/glm.hpp>
+
+namespace Palette
+{
+	// Cor RGBA em float (glm::vec4 não é constexpr em todos os compiladores)
+	struct Color
+	{
+		float r, g, b, a;
+	};
+
+	constexpr Color rgb(float r, float g, float b, float a = 1.0f)
+	{
+		return Color{ r, g, b, a };
+	}
+
+	inline glm::vec3 toVec3(const Color& c)
+	{
+		return glm::vec3(c.r, c.g, c.b);
+	}
+
+	inline glm::vec4 toVec4(const Color& c)
+	{
+		return glm::vec4(c.r, c.g, c.b, c.a);
+	}
+
+	template <class T, size_t N>
+	using Table = std::array<T, N>;
+
+	// Tabela com os valores de fn(0) a fn(N - 1)
+	template <class T, size_t N, class Fn>
+	constexpr Table<T, N> generate(Fn fn)
+	{
+		Table<T, N> table{};
+		for (size_t i = 0; i < N; i++)
+		{
+			table[i] = fn(i);
+		}
+		return table;
+	}
+
+	// Padrão 2D que se repete a cada ROWS linhas e COLUMNS colunas
+	template <class T, size_t ROWS, size_t COLUMNS>
+	struct Pattern
+	{
+		Table<T, ROWS * COLUMNS> cells;
+
+		// Valor em (row, column), para quaisquer row, column >= 0
+		constexpr const T& at(size_t row, size_t column) const
+		{
+			return cells[(row % ROWS) * COLUMNS + column % COLUMNS];
+		}
+	};
+
+	// Padrão com os valores de fn(row, column) num período
+	template <class T, size_t ROWS, size_t COLUMNS, class Fn>
+	constexpr Pattern<T, ROWS, COLUMNS> generatePattern(Fn fn)
+	{
+		Pattern<T, ROWS, COLUMNS> pattern{};
+		for (size_t row = 0; row < ROWS; row++)
+		{
+			for (size_t column = 0; column < COLUMNS; column++)
+			{
+				pattern.cells[row * COLUMNS + column] = fn((int)row, (int)column);
+			}
+		}
+		return pattern;
+	}
+
+	// true se fn(row, column) nos dois primeiros períodos é igual ao valor no primeiro
+	template <size_t ROWS, size_t COLUMNS, class Fn>
+	constexpr bool isPeriodic(Fn fn)
+	{
+		for (size_t row = 0; row < 2 * ROWS; row++)
+		{
+			for (size_t column = 0; column < 2 * COLUMNS; column++)
+			{
+				if (fn((int)row, (int)column) != fn((int)(row % ROWS), (int)(column % COLUMNS)))
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+}
@@ -0,0 +1,184 @@
+// Histórico do caminho percorrido pela cabeça, para posicionar os segmentos por comprimento
+// de arco. Cada posição nova da cabeça entra num buffer circular junto com o comprimento
+// acumulado do caminho até ela (s). O segmento j fica no ponto do caminho com
+// s = s_cabeça - j * espaçamento, achado por busca binária (sample) ou, para a corrente
+// inteira, andando com um cursor do mais novo para o mais antigo (sampleChain, O(n + m)).
+// O espaçamento é exato em qualquer velocidade e o custo não depende de quantos frames
+// passaram: crescer a cobrinha só pede mais comprimento de histórico.
+// Amostras mais antigas que o necessário são descartadas; quando o buffer enche com
+// amostras ainda necessárias, a capacidade dobra.
+
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+#include <vector>
+
+class PathHistory
+{
+public:
+	struct Sample
+	{
+		float x, y;
+		double s; // comprimento do caminho desde o início do histórico
+	};
+
+	// Passos menores que isso não entram no histórico (evita amostras repetidas)
+	static constexpr float MIN_STEP = 1e-3f;
+
+	// Recomeça com um trecho reto de comprimento length terminando em (x, y), na direção (dirX, dirY)
+	void reset(float x, float y, float dirX, float dirY, double length)
+	{
+		if (buffer.empty())
+		{
+			buffer.resize(64);
+		}
+		first = count = 0;
+		if (length > 0.0)
+		{
+			push(Sample{ (float)(x - dirX * length), (float)(y - dirY * length), 0.0 });
+		}
+		push(Sample{ x, y, length > 0.0 ? length : 0.0 });
+	}
+
+	// Comprimento de caminho (atrás da cabeça) que precisa ser mantido
+	void setRequiredLength(double length)
+	{
+		required = length;
+		trim();
+	}
+
+	// Acrescenta a posição atual da cabeça
+	void append(float x, float y)
+	{
+		if (count == 0)
+		{
+			reset(x, y, 0.0f, 0.0f, 0.0);
+			return;
+		}
+		const Sample& head = at(count - 1);
+		float dx = x - head.x, dy = y - head.y;
+		float step = std::sqrt(dx * dx + dy * dy);
+		if (!(step >= MIN_STEP)) // também descarta NaN
+		{
+			return;
+		}
+		push(Sample{ x, y, head.s + step });
+		trim();
+	}
+
+	size_t size() const { return count; }
+	size_t capacity() const { return buffer.size(); }
+
+	// Comprimento coberto pelo histórico
+	double length() const
+	{
+		return count ? at(count - 1).s - at(0).s : 0.0;
+	}
+
+	// Ponto a distance atrás da cabeça, medido ao longo do caminho (busca binária)
+	// As consultas pedem um histórico com pelo menos uma amostra (reset ou append)
+	void sample(double distance, float& x, float& y) const
+	{
+		double target = at(count - 1).s - distance;
+		// Maior k com s[k] <= target
+		size_t lo = 0, hi = count - 1;
+		if (target <= at(0).s)
+		{
+			hi = 0;
+		}
+		while (lo < hi)
+		{
+			size_t mid = (lo + hi + 1) / 2;
+			if (at(mid).s <= target)
+			{
+				lo = mid;
+			}
+			else
+			{
+				hi = mid - 1;
+			}
+		}
+		interpolate(lo, target, x, y);
+	}
+
+	// Posições de n pontos espaçados de spacing ao longo do caminho, a partir da cabeça
+	void sampleChain(double spacing, size_t n, float* x, float* y) const
+	{
+		double headS = at(count - 1).s;
+		size_t k = count - 1;
+		for (size_t j = 0; j < n; j++)
+		{
+			double target = headS - j * spacing;
+			while (k > 0 && at(k).s > target)
+			{
+				k--;
+			}
+			interpolate(k, target, x[j], y[j]);
+		}
+	}
+
+private:
+	std::vector<Sample> buffer; // tamanho sempre potência de 2
+	size_t first = 0;           // índice da amostra mais antiga
+	size_t count = 0;
+	double required = 0.0;
+
+	const Sample& at(size_t k) const
+	{
+		return buffer[(first + k) & (buffer.size() - 1)];
+	}
+
+	void push(const Sample& sample)
+	{
+		if (count == buffer.size())
+		{
+			// Cheio de amostras necessárias: dobra a capacidade, mantendo a ordem
+			std::vector<Sample> grown(buffer.size() * 2);
+			for (size_t k = 0; k < count; k++)
+			{
+				grown[k] = at(k);
+			}
+			buffer.swap(grown);
+			first = 0;
+		}
+		buffer[(first + count) & (buffer.size() - 1)] = sample;
+		count++;
+	}
+
+	// Descarta a amostra mais antiga enquanto a seguinte já cobre o comprimento necessário
+	void trim()
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		double oldestNeeded = at(count - 1).s - required;
+		while (count > 2 && at(1).s <= oldestNeeded)
+		{
+			first = (first + 1) & (buffer.size() - 1);
+			count--;
+		}
+	}
+
+	// Ponto com comprimento target entre as amostras k e k + 1. Antes da amostra mais antiga,
+	// estende o primeiro trecho em linha reta (histórico ainda curto, logo depois de crescer)
+	void interpolate(size_t k, double target, float& x, float& y) const
+	{
+		if (k + 1 >= count)
+		{
+			if (count < 2 || target >= at(count - 1).s)
+			{
+				x = at(count - 1).x;
+				y = at(count - 1).y;
+				return;
+			}
+			k = count - 2;
+		}
+		const Sample& a = at(k);
+		const Sample& b = at(k + 1);
+		double t = (target - a.s) / (b.s - a.s);
+		x = (float)(a.x + (b.x - a.x) * t);
+		y = (float)(a.y + (b.y - a.y) * t);
+	}
+};
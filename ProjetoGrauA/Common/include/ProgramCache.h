@@ -0,0 +1,320 @@
+// Cache em disco de programas de shader já linkados (glGetProgramBinary / glProgramBinary)
+// A chave é um hash do código fonte, dos #defines e do driver (vendor, renderer e versão).
+// Na primeira execução (caminho frio) o programa é compilado e o binário é salvo; nas
+// seguintes (caminho quente) o binário é carregado direto. Se o driver recusar o binário
+// (formato diferente, driver atualizado), o programa volta a ser compilado do código fonte.
+// A GLAD do projeto é da OpenGL 4.0, então as funções da 4.1 / GL_ARB_get_program_binary
+// são carregadas aqui mesmo, via GLFW.
+
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+//GLAD
+#include <glad/glad.h>
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+namespace ProgramCache
+{
+	typedef void (APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+	typedef void (APIENTRYP ProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+	typedef void (APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+
+	struct Stats
+	{
+		int hits = 0;         // programas carregados do binário (caminho quente)
+		int misses = 0;       // programas compilados do código fonte (caminho frio)
+		int rejected = 0;     // binários recusados pelo driver
+		double seconds = 0.0; // tempo total gasto montando programas
+	};
+
+	struct State
+	{
+		bool initialized = false;
+		bool supported = false;
+		GetProgramBinaryProc getProgramBinary = nullptr;
+		ProgramBinaryProc programBinary = nullptr;
+		ProgramParameteriProc programParameteri = nullptr;
+		std::string driver;
+		std::string directory = "shader_cache";
+		Stats stats;
+	};
+
+	inline State& state()
+	{
+		static State s;
+		return s;
+	}
+
+	// Verifica o suporte do driver (precisa de um contexto OpenGL ativo)
+	inline bool init()
+	{
+		State& s = state();
+		if (s.initialized)
+		{
+			return s.supported;
+		}
+		s.initialized = true;
+
+		s.driver = std::string((const char*)glGetString(GL_VENDOR)) + "|" + (const char*)glGetString(GL_RENDERER)
+			+ "|" + (const char*)glGetString(GL_VERSION);
+
+		GLint major = 0, minor = 0, nFormats = 0;
+		glGetIntegerv(GL_MAJOR_VERSION, &major);
+		glGetIntegerv(GL_MINOR_VERSION, &minor);
+		if (major > 4 || (major == 4 && minor >= 1) || glfwExtensionSupported("GL_ARB_get_program_binary"))
+		{
+			s.getProgramBinary = (GetProgramBinaryProc)glfwGetProcAddress("glGetProgramBinary");
+			s.programBinary = (ProgramBinaryProc)glfwGetProcAddress("glProgramBinary");
+			s.programParameteri = (ProgramParameteriProc)glfwGetProcAddress("glProgramParameteri");
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nFormats);
+		}
+		s.supported = s.getProgramBinary && s.programBinary && s.programParameteri && nFormats > 0;
+		if (!s.supported)
+		{
+			std::cout << "ProgramCache: driver sem suporte a program binary, compilando sempre" << std::endl;
+		}
+		return s.supported;
+	}
+
+	inline void setDirectory(const std::string& directory)
+	{
+		state().directory = directory;
+	}
+
+	// FNV-1a de 64 bits
+	inline uint64_t hash(const std::string& text, uint64_t h = 14695981039346656037ull)
+	{
+		for (unsigned char c : text)
+		{
+			h ^= c;
+			h *= 1099511628211ull;
+		}
+		return h;
+	}
+
+	inline std::string keyFor(const std::string& vertexCode, const std::string& fragmentCode, const std::string& defines)
+	{
+		uint64_t h = hash(state().driver);
+		h = hash(defines, h);
+		h = hash(vertexCode, h ^ 0x76); // separadores, para "ab"+"c" não colidir com "a"+"bc"
+		h = hash(fragmentCode, h ^ 0x66);
+		std::ostringstream key;
+		key << std::hex << std::setw(16) << std::setfill('0') << h;
+		return key.str();
+	}
+
+	// Insere os #defines logo depois da linha #version
+	inline std::string injectDefines(const std::string& code, const std::string& defines)
+	{
+		if (defines.empty())
+		{
+			return code;
+		}
+		size_t version = code.find("#version");
+		if (version == std::string::npos)
+		{
+			return defines + "\n" + code;
+		}
+		size_t lineEnd = code.find('\n', version);
+		if (lineEnd == std::string::npos)
+		{
+			return code + "\n" + defines + "\n";
+		}
+		return code.substr(0, lineEnd + 1) + defines + "\n" + code.substr(lineEnd + 1);
+	}
+
+	inline std::string pathFor(const std::string& key)
+	{
+		return state().directory + "/" + key + ".bin";
+	}
+
+	// Tenta criar o programa a partir do binário salvo. Retorna 0 se não houver binário
+	// ou se o driver não aceitar
+	inline GLuint tryLoad(const std::string& key)
+	{
+		State& s = state();
+		if (!init())
+		{
+			return 0;
+		}
+
+		std::ifstream file(pathFor(key), std::ios::binary);
+		if (!file)
+		{
+			return 0;
+		}
+		char magic[4];
+		uint32_t format = 0, length = 0;
+		file.read(magic, 4);
+		file.read((char*)&format, sizeof(format));
+		file.read((char*)&length, sizeof(length));
+		if (!file || std::string(magic, 4) != "PGBC" || length == 0)
+		{
+			return 0;
+		}
+		std::vector<char> binary(length);
+		if (!file.read(binary.data(), length))
+		{
+			return 0;
+		}
+
+		GLuint program = glCreateProgram();
+		s.programBinary(program, format, binary.data(), (GLsizei)length);
+		GLint success = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+		if (!success)
+		{
+			// Formato incompatível: descarta e deixa o chamador compilar
+			glDeleteProgram(program);
+			s.stats.rejected++;
+			return 0;
+		}
+		return program;
+	}
+
+	// Pede ao driver para manter o binário disponível (chamar antes do glLinkProgram)
+	inline void markRetrievable(GLuint program)
+	{
+		if (init())
+		{
+			state().programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+	}
+
+	// Salva o binário de um programa linkado com sucesso
+	inline void store(const std::string& key, GLuint program)
+	{
+		State& s = state();
+		if (!init())
+		{
+			return;
+		}
+
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0)
+		{
+			return;
+		}
+		std::vector<char> binary(length);
+		GLenum format = 0;
+		s.getProgramBinary(program, length, nullptr, &format, binary.data());
+
+		std::error_code ec;
+		std::filesystem::create_directories(s.directory, ec);
+		std::ofstream file(pathFor(key), std::ios::binary);
+		if (!file)
+		{
+			std::cout << "ProgramCache: nao foi possivel gravar " << pathFor(key) << std::endl;
+			return;
+		}
+		uint32_t format32 = format, length32 = (uint32_t)length;
+		file.write("PGBC", 4);
+		file.write((const char*)&format32, sizeof(format32));
+		file.write((const char*)&length32, sizeof(length32));
+		file.write(binary.data(), length);
+	}
+
+	// Compila e linka a partir do código fonte (com as mensagens de erro de sempre)
+	inline GLuint compile(const std::string& vertexCode, const std::string& fragmentCode)
+	{
+		const GLchar* vShaderCode = vertexCode.c_str();
+		const GLchar* fShaderCode = fragmentCode.c_str();
+		GLint success;
+		GLchar infoLog[512];
+
+		GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
+		glShaderSource(vertex, 1, &vShaderCode, NULL);
+		glCompileShader(vertex);
+		glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
+		if (!success)
+		{
+			glGetShaderInfoLog(vertex, 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+		}
+
+		GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(fragment, 1, &fShaderCode, NULL);
+		glCompileShader(fragment);
+		glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
+		if (!success)
+		{
+			glGetShaderInfoLog(fragment, 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+		}
+
+		GLuint program = glCreateProgram();
+		glAttachShader(program, vertex);
+		glAttachShader(program, fragment);
+		markRetrievable(program);
+		glLinkProgram(program);
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+		if (!success)
+		{
+			glGetProgramInfoLog(program, 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+		}
+		glDeleteShader(vertex);
+		glDeleteShader(fragment);
+
+		return program;
+	}
+
+	// Monta o programa: binário do cache se possível, senão compila e salva.
+	// O tempo gasto é mostrado no terminal, indicando se foi o caminho frio ou quente
+	inline GLuint build(const std::string& vertexCode, const std::string& fragmentCode, const std::string& defines = "")
+	{
+		State& s = state();
+		auto start = std::chrono::steady_clock::now();
+		init();
+
+		std::string vs = injectDefines(vertexCode, defines);
+		std::string fs = injectDefines(fragmentCode, defines);
+		std::string key = keyFor(vs, fs, defines);
+
+		GLuint program = tryLoad(key);
+		bool warm = program != 0;
+		if (warm)
+		{
+			s.stats.hits++;
+		}
+		else
+		{
+			s.stats.misses++;
+			program = compile(vs, fs);
+			GLint success = 0;
+			glGetProgramiv(program, GL_LINK_STATUS, &success);
+			if (success)
+			{
+				store(key, program);
+			}
+		}
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		s.stats.seconds += seconds;
+		std::cout << "Shader " << key << ": " << seconds * 1000.0 << " ms ("
+			<< (warm ? "cache quente, binario carregado" : "cache frio, compilado") << ")" << std::endl;
+		return program;
+	}
+}
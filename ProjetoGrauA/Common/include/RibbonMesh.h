@@ -0,0 +1,162 @@
+// Malha contínua ao longo de uma linha central: uma fita de largura constante com pontas
+// arredondadas, gerada a cada frame como um único GL_TRIANGLE_STRIP.
+// A fita vai da cauda (último ponto) até a cabeça (ponto 0). Cada ponto central gera um par
+// de vértices (esquerda, direita) na direção normal à linha; as pontas são meias-voltas com
+// capSegments divisões, emitidas como pares simétricos que fecham no vértice da ponta.
+// Cada ponto é o centro de uma faixa de cor que vai até a metade do caminho para os vizinhos;
+// na divisa entre faixas o par de vértices é repetido com a cor nova (quad de área zero),
+// então as cores não se misturam.
+// Formato dos vértices: x, y, z (atributo 0) e r, g, b, a (atributo 2), para a variante
+// VERTEX_COLOR do shader de sprite.
+
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+#include <vector>
+
+//GLAD
+#include <glad/glad.h>
+
+//GLM
+#include <glm/glm.hpp>
+
+class RibbonMesh
+{
+public:
+	int capSegments = 8; // divisões de cada ponta (meia-volta)
+
+	// Cria o VAO e o buffer de vértices (reenviado a cada frame)
+	void init()
+	{
+		glGenVertexArrays(1, &VAO);
+		glGenBuffers(1, &VBO);
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(GLfloat), (GLvoid*)0);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
+		glEnableVertexAttribArray(2);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+
+	// Gera a fita sobre os pontos (x[i], y[i]), i = 0 (cabeça) ... n - 1 (cauda).
+	// colorOf(i) devolve a cor (glm::vec3) do ponto i
+	template <class ColorFn>
+	void build(const float* x, const float* y, size_t n, float radius, ColorFn colorOf)
+	{
+		vertices.clear();
+		if (n == 0)
+		{
+			return;
+		}
+
+		// k = 0 é a cauda, k = n - 1 é a cabeça
+		auto point = [&](size_t k) { return glm::vec2(x[n - 1 - k], y[n - 1 - k]); };
+		auto color = [&](size_t k) { return glm::vec4(colorOf((int)(n - 1 - k)), 1.0f); };
+		glm::vec2 forward(1.0f, 0.0f);
+		auto direction = [&](size_t a, size_t b)
+		{
+			glm::vec2 d = point(b) - point(a);
+			float len = glm::length(d);
+			if (len > 0.0f)
+			{
+				forward = d / len;
+			}
+			return forward;
+		};
+
+		// Ponta da cauda: do vértice da ponta até a borda da fita
+		glm::vec2 f = direction(0, n > 1 ? 1 : 0);
+		emitCap(point(0), -f, radius, color(0), false);
+
+		for (size_t k = 1; k < n; k++)
+		{
+			// Divisa entre as faixas k - 1 e k, no meio do trecho
+			glm::vec2 mid = 0.5f * (point(k - 1) + point(k));
+			glm::vec2 segmentDir = direction(k - 1, k);
+			emitPair(mid, segmentDir, radius, color(k - 1));
+			emitPair(mid, segmentDir, radius, color(k));
+
+			// Centro da faixa k, com a direção média dos dois trechos vizinhos
+			f = direction(k - 1, k + 1 < n ? k + 1 : k);
+			emitPair(point(k), f, radius, color(k));
+		}
+
+		// Ponta da cabeça: da borda da fita até o vértice da ponta
+		emitCap(point(n - 1), f, radius, color(n - 1), true);
+	}
+
+	// Envia os vértices e desenha a fita inteira em um draw call
+	void draw()
+	{
+		if (vertices.empty())
+		{
+			return;
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		if (vertices.size() > capacity)
+		{
+			capacity = vertices.size() * 2;
+		}
+		// Realoca (orphaning) para não esperar o frame anterior
+		glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(GLfloat), NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(GLfloat), vertices.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		glBindVertexArray(VAO);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, (GLsizei)vertexCount());
+		glBindVertexArray(0);
+	}
+
+	size_t vertexCount() const
+	{
+		return vertices.size() / FLOATS_PER_VERTEX;
+	}
+
+private:
+	static const int FLOATS_PER_VERTEX = 7;
+
+	std::vector<GLfloat> vertices;
+	GLuint VAO = 0, VBO = 0;
+	size_t capacity = 0; // em floats
+
+	void emit(glm::vec2 p, glm::vec4 c)
+	{
+		GLfloat v[FLOATS_PER_VERTEX] = { p.x, p.y, 0.0f, c.r, c.g, c.b, c.a };
+		vertices.insert(vertices.end(), v, v + FLOATS_PER_VERTEX);
+	}
+
+	// Par esquerda/direita em relação à direção de avanço (da cauda para a cabeça)
+	void emitPair(glm::vec2 center, glm::vec2 forward, float radius, glm::vec4 c)
+	{
+		glm::vec2 normal(-forward.y, forward.x);
+		emit(center + radius * normal, c);
+		emit(center - radius * normal, c);
+	}
+
+	// Meia-volta em torno de center, apontando para outward. Na cauda vai da ponta até a borda
+	// da fita; na cabeça (head = true), da borda até a ponta. O par da borda da cabeça coincide
+	// com o par do ponto central, já emitido, então é pulado
+	void emitCap(glm::vec2 center, glm::vec2 outward, float radius, glm::vec4 c, bool head)
+	{
+		// Normal à esquerda do avanço: na cauda o avanço é -outward, na cabeça é outward
+		glm::vec2 forward = head ? outward : -outward;
+		glm::vec2 normal(-forward.y, forward.x);
+		const float halfPi = 1.57079632679f;
+		for (int j = 0; j <= capSegments; j++)
+		{
+			int step = head ? capSegments - j : j;
+			if (head && j == 0)
+			{
+				continue;
+			}
+			float theta = halfPi * step / (float)capSegments;
+			glm::vec2 along = radius * std::cos(theta) * outward;
+			glm::vec2 across = radius * std::sin(theta) * normal;
+			emit(center + along + across, c);
+			emit(center + along - across, c);
+		}
+	}
+};
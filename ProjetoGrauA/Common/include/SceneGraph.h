@@ -0,0 +1,163 @@
+// Grafo de cena 2D: transformações com pai e filhos, recalculadas só quando mudam
+// Cada nó tem uma transformação local (posição, ângulo em torno de z, escala) e a matriz de
+// mundo = mundo do pai * local. Os nós ficam em arrays paralelos (SoA), na ordem em que são
+// criados; como o pai precisa existir antes do filho, essa ordem já é topológica e update()
+// resolve tudo numa passada só, do início ao fim dos arrays.
+// Os setters só marcam o nó como sujo se o valor mudou de verdade, então quem reenvia a
+// mesma posição todo frame não custa nada. Cada nó guarda a versão da sua matriz de mundo
+// (aumenta a cada recálculo) e a versão do pai que usou: um filho é recalculado quando ele
+// mesmo mudou ou quando o pai tem matriz nova, e subárvores paradas ficam de fora.
+// world(node) também funciona sem update(): recalcula só a cadeia de ancestrais do nó.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+
+//GLM
+#include <glm/glm.hpp>
+
+class SceneGraph
+{
+public:
+	static const int NO_PARENT = -1;
+
+	// Cria um nó (filho de parent, que já precisa existir) e retorna o seu índice
+	int add(int parent = NO_PARENT)
+	{
+		int node = (int)parents.size();
+		int p = NO_PARENT;
+		if (parent >= 0 && parent < node)
+		{
+			p = parent;
+		}
+		parents.push_back(p);
+		positions.push_back(glm::vec3(0.0f));
+		angles.push_back(0.0f);
+		scales.push_back(glm::vec3(1.0f));
+		worlds.push_back(glm::mat4(1.0f));
+		dirty.push_back(1);
+		versions.push_back(0);
+		parentVersions.push_back(0);
+		return node;
+	}
+
+	void setPosition(int node, glm::vec3 position)
+	{
+		if (positions[node] != position)
+		{
+			positions[node] = position;
+			dirty[node] = 1;
+		}
+	}
+
+	// Ângulo em radianos, em torno de z
+	void setAngle(int node, float angle)
+	{
+		if (angles[node] != angle)
+		{
+			angles[node] = angle;
+			dirty[node] = 1;
+		}
+	}
+
+	void setScale(int node, glm::vec3 scale)
+	{
+		if (scales[node] != scale)
+		{
+			scales[node] = scale;
+			dirty[node] = 1;
+		}
+	}
+
+	void setTransform(int node, glm::vec3 position, float angle, glm::vec3 scale)
+	{
+		setPosition(node, position);
+		setAngle(node, angle);
+		setScale(node, scale);
+	}
+
+	glm::vec3 position(int node) const { return positions[node]; }
+	float angle(int node) const { return angles[node]; }
+	glm::vec3 scale(int node) const { return scales[node]; }
+	int parent(int node) const { return parents[node]; }
+	size_t size() const { return parents.size(); }
+
+	// Recalcula as matrizes de mundo que mudaram. Retorna quantas foram recalculadas
+	size_t update()
+	{
+		size_t updated = 0;
+		for (size_t node = 0; node < parents.size(); node++)
+		{
+			if (stale((int)node))
+			{
+				recompute((int)node);
+				updated++;
+			}
+		}
+		lastUpdated = updated;
+		return updated;
+	}
+
+	// Matriz de mundo do nó, recalculando antes o que estiver desatualizado nos ancestrais
+	const glm::mat4& world(int node)
+	{
+		int p = parents[node];
+		if (p != NO_PARENT)
+		{
+			world(p);
+		}
+		if (stale(node))
+		{
+			recompute(node);
+		}
+		return worlds[node];
+	}
+
+	// Matrizes recalculadas no último update()
+	size_t updatedLastFrame() const { return lastUpdated; }
+
+private:
+	std::vector<int> parents;
+	std::vector<glm::vec3> positions;
+	std::vector<float> angles;
+	std::vector<glm::vec3> scales;
+	std::vector<glm::mat4> worlds;
+	std::vector<uint8_t> dirty;
+	std::vector<uint32_t> versions, parentVersions;
+	size_t lastUpdated = 0;
+
+	bool stale(int node) const
+	{
+		int p = parents[node];
+		return dirty[node] || (p != NO_PARENT && parentVersions[node] != versions[p]);
+	}
+
+	// translate * rotate(z) * scale, montada direto
+	void recompute(int node)
+	{
+		float c = std::cos(angles[node]), s = std::sin(angles[node]);
+		const glm::vec3& t = positions[node];
+		const glm::vec3& k = scales[node];
+		glm::mat4 local(
+			c * k.x, s * k.x, 0.0f, 0.0f,
+			-s * k.y, c * k.y, 0.0f, 0.0f,
+			0.0f, 0.0f, k.z, 0.0f,
+			t.x, t.y, t.z, 1.0f);
+
+		int p = parents[node];
+		if (p != NO_PARENT)
+		{
+			worlds[node] = worlds[p] * local;
+			parentVersions[node] = versions[p];
+		}
+		else
+		{
+			worlds[node] = local;
+		}
+		dirty[node] = 0;
+		versions[node]++;
+	}
+};
@@ -0,0 +1,251 @@
+// Grade uniforme sobre os centros dos segmentos, para detectar colisão da cobrinha com ela mesma
+// O plano é dividido em células quadradas de lado cellSize (>= distância de contato), então
+// tudo o que está a menos de cellSize de um ponto fica nas 3x3 células em volta da dele.
+// O plano não tem limites: a célula (cx, cy) entra numa tabela de espalhamento com potência
+// de 2 entradas (>= 2n), e células diferentes que caem na mesma entrada só geram candidatos
+// a mais, descartados pelo teste de distância.
+// A grade é refeita a cada frame com uma ordenação por contagem (O(n), sem alocação depois que
+// os buffers cresceram): as posições são copiadas em ordem de célula, então uma consulta lê
+// poucos trechos contíguos. Com a grade pronta, a consulta da cabeça custa O(1) em média e
+// todos os pares próximos saem em O(n), contra O(n) e O(n^2) da busca direta.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+class SegmentGrid
+{
+public:
+	// Monta a grade sobre os pontos (x[i], y[i]), i = 0 ... n - 1
+	void build(const float* x, const float* y, size_t n, float cellSize)
+	{
+		count = n;
+		invCell = 1.0f / cellSize;
+		size_t tableSize = 16;
+		while (tableSize < 2 * n)
+		{
+			tableSize *= 2;
+		}
+		mask = (uint32_t)(tableSize - 1);
+
+		cellStart.assign(tableSize + 1, 0);
+		cellOf.resize(n);
+		sortedX.resize(n);
+		sortedY.resize(n);
+		sortedIndex.resize(n);
+
+		// Contagem por entrada, soma de prefixos e distribuição
+		for (size_t i = 0; i < n; i++)
+		{
+			cellOf[i] = slot(cellCoord(x[i]), cellCoord(y[i]));
+			cellStart[cellOf[i] + 1]++;
+		}
+		for (size_t c = 0; c < tableSize; c++)
+		{
+			cellStart[c + 1] += cellStart[c];
+		}
+		cursor.assign(cellStart.begin(), cellStart.end() - 1);
+		for (size_t i = 0; i < n; i++)
+		{
+			uint32_t k = cursor[cellOf[i]]++;
+			sortedX[k] = x[i];
+			sortedY[k] = y[i];
+			sortedIndex[k] = (uint32_t)i;
+		}
+	}
+
+	// Menor índice >= minIndex com centro a menos de radius de (px, py), ou -1
+	long query(float px, float py, float radius, size_t minIndex) const
+	{
+		long hit = -1;
+		const float r2 = radius * radius;
+		uint32_t slots[9];
+		int nSlots = neighborSlots(px, py, slots);
+		for (int t = 0; t < nSlots; t++)
+		{
+			uint32_t s = slots[t];
+			for (uint32_t k = cellStart[s]; k < cellStart[s + 1]; k++)
+			{
+				float dx = sortedX[k] - px, dy = sortedY[k] - py;
+				uint32_t i = sortedIndex[k];
+				if (i >= minIndex && dx * dx + dy * dy < r2 && (hit < 0 || i < (size_t)hit))
+				{
+					hit = (long)i;
+				}
+			}
+		}
+		return hit;
+	}
+
+	// Chama fn(i, j), i < j, para cada par de pontos a menos de radius com j - i >= minGap
+	// (vizinhos na corrente sempre se encostam e não contam)
+	template <class PairFn>
+	void forEachPair(float radius, size_t minGap, PairFn fn) const
+	{
+		const float r2 = radius * radius;
+		for (uint32_t a = 0; a < count; a++)
+		{
+			float px = sortedX[a], py = sortedY[a];
+			uint32_t i = sortedIndex[a];
+			uint32_t slots[9];
+			int nSlots = neighborSlots(px, py, slots);
+			for (int t = 0; t < nSlots; t++)
+			{
+				uint32_t s = slots[t];
+				for (uint32_t k = cellStart[s]; k < cellStart[s + 1]; k++)
+				{
+					uint32_t j = sortedIndex[k];
+					float dx = sortedX[k] - px, dy = sortedY[k] - py;
+					if (j > i && j - i >= minGap && dx * dx + dy * dy < r2)
+					{
+						fn((size_t)i, (size_t)j);
+					}
+				}
+			}
+		}
+	}
+
+	size_t size() const { return count; }
+
+	// ------------------------------------------------------------------------
+	// Benchmark (FollowMouse.exe --bench): construção da grade e consultas contra a busca
+	// direta, com a corrente enrolada numa espiral (muitos segmentos próximos)
+
+	static void benchmark()
+	{
+		std::cout << "SegmentGrid: colisao da cabeca e de todos os pares" << std::endl;
+		const float spacing = 20.0f, diameter = 50.0f;
+		const size_t minGap = 4;
+		for (size_t n : { (size_t)100, (size_t)10000, (size_t)1000000 })
+		{
+			// Espiral de Arquimedes com 0.9 diâmetro entre as voltas (cada volta encosta na seguinte)
+			std::vector<float> x(n), y(n);
+			float theta = 0.0f;
+			const float b = 0.9f * diameter / (2.0f * 3.14159265f);
+			for (size_t i = 0; i < n; i++)
+			{
+				float r = diameter + b * theta;
+				x[i] = r * std::cos(theta);
+				y[i] = r * std::sin(theta);
+				theta += spacing / r;
+			}
+			int steps = (int)std::max((size_t)3, (size_t)2000000 / n);
+			// Cabeça fora da espiral, sem colisão: a busca direta passa por todos os segmentos
+			float headX = -x[n - 1], headY = -y[n - 1] - 2.0f * diameter;
+
+			SegmentGrid grid;
+			long gridHit = 0, naiveHit = 0;
+			auto start = std::chrono::steady_clock::now();
+			for (int s = 0; s < steps; s++)
+			{
+				grid.build(x.data(), y.data(), n, diameter);
+			}
+			double buildTime = seconds(start) / steps;
+
+			start = std::chrono::steady_clock::now();
+			for (int s = 0; s < steps; s++)
+			{
+				gridHit += grid.query(headX, headY, diameter, minGap);
+			}
+			double queryTime = seconds(start) / steps;
+
+			start = std::chrono::steady_clock::now();
+			for (int s = 0; s < steps; s++)
+			{
+				naiveHit += naiveQuery(x.data(), y.data(), n, headX, headY, diameter, minGap);
+			}
+			double naiveTime = seconds(start) / steps;
+
+			size_t gridPairs = 0;
+			start = std::chrono::steady_clock::now();
+			grid.forEachPair(diameter, minGap, [&](size_t, size_t) { gridPairs++; });
+			double pairsTime = seconds(start);
+
+			std::cout << "  " << n << " segmentos: grade " << buildTime * 1.0e6 << " us + consulta "
+				<< queryTime * 1.0e9 << " ns, busca direta " << naiveTime * 1.0e6 << " us";
+			if (gridHit != naiveHit)
+			{
+				std::cout << " ERROR::SEGMENTGRID::QUERY_MISMATCH";
+			}
+			std::cout << "; pares: grade " << pairsTime * 1.0e3 << " ms (" << gridPairs << ")";
+			if (n <= 10000)
+			{
+				size_t naivePairs = 0;
+				start = std::chrono::steady_clock::now();
+				for (size_t i = 0; i < n; i++)
+				{
+					for (size_t j = i + minGap; j < n; j++)
+					{
+						float dx = x[j] - x[i], dy = y[j] - y[i];
+						naivePairs += dx * dx + dy * dy < diameter * diameter;
+					}
+				}
+				std::cout << ", busca direta " << seconds(start) * 1.0e3 << " ms (" << naivePairs << ")";
+			}
+			std::cout << std::endl;
+		}
+	}
+
+private:
+	size_t count = 0;
+	float invCell = 1.0f;
+	uint32_t mask = 0;
+	std::vector<uint32_t> cellStart; // início de cada entrada em sorted*, mais o fim
+	std::vector<uint32_t> cellOf, cursor;
+	std::vector<float> sortedX, sortedY;
+	std::vector<uint32_t> sortedIndex;
+
+	int cellCoord(float v) const
+	{
+		return (int)std::floor(v * invCell);
+	}
+
+	uint32_t slot(int cx, int cy) const
+	{
+		return ((uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u) & mask;
+	}
+
+	// Entradas das 3x3 células em volta de (px, py), sem repetição (células diferentes podem
+	// cair na mesma entrada, e os pontos dela seriam visitados duas vezes)
+	int neighborSlots(float px, float py, uint32_t* slots) const
+	{
+		int cx = cellCoord(px), cy = cellCoord(py);
+		int n = 0;
+		for (int oy = -1; oy <= 1; oy++)
+		{
+			for (int ox = -1; ox <= 1; ox++)
+			{
+				uint32_t s = slot(cx + ox, cy + oy);
+				if (std::find(slots, slots + n, s) == slots + n)
+				{
+					slots[n++] = s;
+				}
+			}
+		}
+		return n;
+	}
+
+	static long naiveQuery(const float* x, const float* y, size_t n, float px, float py, float radius, size_t minIndex)
+	{
+		for (size_t i = minIndex; i < n; i++)
+		{
+			float dx = x[i] - px, dy = y[i] - py;
+			if (dx * dx + dy * dy < radius * radius)
+			{
+				return (long)i;
+			}
+		}
+		return -1;
+	}
+
+	static double seconds(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+};
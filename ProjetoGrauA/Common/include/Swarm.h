@@ -0,0 +1,123 @@
+// Enxame de cobrinhas independentes, para testar a carga do solver da corrente
+// Todas as cobrinhas têm o mesmo número de segmentos e ficam num único par de arrays SoA
+// (x[] e y[]): a cobrinha s ocupa [s * length, (s + 1) * length), com a cabeça no início.
+// Cada cobrinha persegue um alvo sorteado dentro da área; ao chegar perto, sorteia outro
+// (gerador xorshift próprio, sem estado compartilhado entre threads). A atualização divide
+// as cobrinhas entre os núcleos (WorkerPool) e cada uma passa pelo ChainSolver; como as
+// cobrinhas não se enxergam, os blocos não precisam de sincronização.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+
+#include "ChainSolver.h"
+#include "WorkerPool.h"
+
+class Swarm
+{
+public:
+	// Distâncias entre segmentos e amortecimento do solver, em pixels
+	ChainSolver::Params params = { 0.5f, 6.0f, 8.0f };
+	float speed = 120.0f; // pixels por segundo
+
+	std::vector<float> x, y;
+
+	// Cria snakes cobrinhas de length segmentos, esticadas em direções aleatórias
+	void init(size_t snakes, size_t length, float width, float height, uint32_t seed = 1)
+	{
+		nSnakes = snakes;
+		snakeLength = length;
+		areaWidth = width;
+		areaHeight = height;
+		x.resize(snakes * length);
+		y.resize(snakes * length);
+		targets.resize(snakes);
+
+		for (size_t s = 0; s < snakes; s++)
+		{
+			Target& t = targets[s];
+			t.rng = seed + (uint32_t)s * 2654435761u;
+			if (t.rng == 0)
+			{
+				t.rng = 1;
+			}
+			float hx = random(t.rng) * width, hy = random(t.rng) * height;
+			float angle = random(t.rng) * 6.2831853f;
+			for (size_t i = 0; i < length; i++)
+			{
+				x[s * length + i] = hx - std::cos(angle) * params.maxDistance * i;
+				y[s * length + i] = hy - std::sin(angle) * params.maxDistance * i;
+			}
+			pickTarget(t);
+		}
+	}
+
+	// Move as cabeças dt segundos e resolve as correntes, em paralelo
+	void update(float dt, WorkerPool& pool)
+	{
+		const size_t grain = 64; // cobrinhas por bloco
+		pool.parallelFor(nSnakes, grain, [&](size_t begin, size_t end)
+		{
+			for (size_t s = begin; s < end; s++)
+			{
+				updateSnake(s, dt);
+			}
+		});
+	}
+
+	size_t snakes() const { return nSnakes; }
+	size_t length() const { return snakeLength; }
+	size_t segments() const { return x.size(); }
+
+private:
+	struct Target
+	{
+		float x, y;
+		uint32_t rng;
+	};
+
+	size_t nSnakes = 0, snakeLength = 0;
+	float areaWidth = 0.0f, areaHeight = 0.0f;
+	std::vector<Target> targets;
+
+	// xorshift32, em [0, 1)
+	static float random(uint32_t& state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return (state >> 8) * (1.0f / 16777216.0f);
+	}
+
+	void pickTarget(Target& t)
+	{
+		t.x = random(t.rng) * areaWidth;
+		t.y = random(t.rng) * areaHeight;
+	}
+
+	void updateSnake(size_t s, float dt)
+	{
+		float* sx = x.data() + s * snakeLength;
+		float* sy = y.data() + s * snakeLength;
+		Target& t = targets[s];
+
+		float dx = t.x - sx[0], dy = t.y - sy[0];
+		float dist = std::sqrt(dx * dx + dy * dy);
+		float step = speed * dt;
+		if (dist <= step)
+		{
+			sx[0] = t.x;
+			sy[0] = t.y;
+			pickTarget(t);
+		}
+		else
+		{
+			sx[0] += dx / dist * step;
+			sy[0] += dy / dist * step;
+		}
+		ChainSolver::solve(sx, sy, snakeLength, params);
+	}
+};
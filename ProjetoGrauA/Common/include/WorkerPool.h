@@ -0,0 +1,146 @@
+// Grupo fixo de threads para dividir laços entre os núcleos
+// As threads são criadas uma vez só e ficam dormindo entre um laço e outro. parallelFor
+// divide [0, count) em blocos de grain itens; as threads (e a que chamou, que também
+// trabalha) pegam o próximo bloco de um contador atômico até acabar, e a chamada só volta
+// quando todas as threads que entraram no laço saíram dele.
+// Um laço de cada vez: parallelFor não é reentrante.
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <algorithm>
+
+class WorkerPool
+{
+public:
+	// workers = 0: uma thread por núcleo, contando a que chama parallelFor
+	explicit WorkerPool(unsigned workers = 0)
+	{
+		if (workers == 0)
+		{
+			unsigned cores = std::thread::hardware_concurrency();
+			workers = cores > 1 ? cores - 1 : 0;
+		}
+		for (unsigned t = 0; t < workers; t++)
+		{
+			threads.emplace_back([this]() { workerLoop(); });
+		}
+	}
+
+	~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	// Threads que trabalham num laço (as do grupo mais a que chama)
+	unsigned size() const
+	{
+		return (unsigned)threads.size() + 1;
+	}
+
+	// Chama fn(begin, end) para blocos que cobrem [0, count)
+	void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		grain = std::max(grain, (size_t)1);
+		size_t blocks = (count + grain - 1) / grain;
+		if (threads.empty() || blocks == 1)
+		{
+			fn(0, count);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			job = &fn;
+			jobCount = count;
+			jobGrain = grain;
+			nextBlock = 0;
+			generation++;
+		}
+		wake.notify_all();
+
+		runBlocks();
+
+		// Todos os blocos já foram pegos; espera as threads que ainda estão com algum. Depois
+		// disso nenhuma thread entra mais neste laço (job = nullptr)
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [this]() { return active == 0; });
+		job = nullptr;
+	}
+
+private:
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable wake, done;
+	bool stopping = false;
+	unsigned long generation = 0;
+
+	const std::function<void(size_t, size_t)>* job = nullptr;
+	size_t jobCount = 0, jobGrain = 1;
+	std::atomic<size_t> nextBlock{ 0 };
+	unsigned active = 0; // threads do grupo dentro de runBlocks (protegido por mutex)
+
+	void workerLoop()
+	{
+		unsigned long seen = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [&]() { return stopping || generation != seen; });
+				if (stopping)
+				{
+					return;
+				}
+				seen = generation;
+				// Acordou depois que o laço terminou: não há o que fazer
+				if (job == nullptr)
+				{
+					continue;
+				}
+				active++;
+			}
+			runBlocks();
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				active--;
+				if (active == 0)
+				{
+					done.notify_one();
+				}
+			}
+		}
+	}
+
+	// Pega blocos até acabarem
+	void runBlocks()
+	{
+		size_t blocks = (jobCount + jobGrain - 1) / jobGrain;
+		for (size_t b = nextBlock++; b < blocks; b = nextBlock++)
+		{
+			size_t begin = b * jobGrain;
+			(*job)(begin, std::min(begin + jobGrain, jobCount));
+		}
+	}
+};
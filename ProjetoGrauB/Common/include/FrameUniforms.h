@@ -0,0 +1,77 @@
+// Bloco uniforme compartilhado com os dados de câmera e do frame
+// Um único uniform buffer (layout std140) guarda projeção, view, viewport e tempo; ele fica
+// ligado no ponto de ligação FRAME_DATA_BINDING e é atualizado uma vez por frame, servindo
+// para todos os programas de shader. Nos shaders, o bloco é declarado assim:
+//
+//   layout (std140) uniform FrameData
+//   {
+//       mat4 projection;
+//       mat4 view;
+//       vec2 viewport;
+//       float time;
+//   };
+//
+// A GLSL 4.00 não aceita layout(binding = N) em blocos, então a ligação de cada programa é
+// feita em C++ (ver ShaderLibrary::bindUniformBlock).
+
+#pragma once
+
+#include <cstddef>
+
+//GLAD
+#include <glad/glad.h>
+
+//GLM
+#include <glm/glm.hpp>
+
+const GLuint FRAME_DATA_BINDING = 0;
+
+// Espelho em C++ do bloco FrameData; a ordem e os tamanhos seguem as regras do std140
+struct FrameData
+{
+	glm::mat4 projection; // 64 bytes, alinhamento 16
+	glm::mat4 view;       // 64 bytes, alinhamento 16
+	glm::vec2 viewport;   // 8 bytes, alinhamento 8
+	float time;           // 4 bytes
+	float padding;        // o bloco é arredondado para múltiplo de 16
+};
+
+static_assert(sizeof(glm::mat4) == 64 && sizeof(glm::vec2) == 8, "glm sem empacotamento esperado");
+static_assert(offsetof(FrameData, projection) == 0, "FrameData::projection fora do layout std140");
+static_assert(offsetof(FrameData, view) == 64, "FrameData::view fora do layout std140");
+static_assert(offsetof(FrameData, viewport) == 128, "FrameData::viewport fora do layout std140");
+static_assert(offsetof(FrameData, time) == 136, "FrameData::time fora do layout std140");
+static_assert(sizeof(FrameData) == 144, "FrameData com tamanho diferente do bloco std140");
+
+class FrameUniforms
+{
+public:
+	FrameData data;
+
+	// Cria o buffer e o liga ao ponto FRAME_DATA_BINDING
+	void init()
+	{
+		data.projection = glm::mat4(1);
+		data.view = glm::mat4(1);
+		data.viewport = glm::vec2(0.0, 0.0);
+		data.time = 0.0;
+		data.padding = 0.0;
+
+		glGenBuffers(1, &UBO);
+		glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), &data, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, UBO);
+	}
+
+	// Envia o conteúdo de data para a GPU (uma vez por frame)
+	void update()
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &data);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+private:
+	GLuint UBO = 0;
+};
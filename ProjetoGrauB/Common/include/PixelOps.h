@@ -0,0 +1,356 @@
+// Operações de pixel aplicadas na carga das texturas, logo após o stbi_load
+//  - expansão de 3 para 4 canais (RGB -> RGBA)
+//  - pré-multiplicação do alfa (RGB *= A), para usar glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA)
+//  - troca dos canais R e B (RGBA -> BGRA), formato de upload nativo da maioria dos drivers
+// Cada operação tem uma versão escalar e versões SIMD (SSE2/SSSE3/AVX2), escolhidas
+// em tempo de execução conforme o que a CPU suporta.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PIXELOPS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace PixelOps
+{
+	// Conjunto de instruções usado pelos kernels
+	enum Isa { SCALAR, SSE2, SSSE3, AVX2 };
+
+	inline const char* isaName(Isa isa)
+	{
+		switch (isa)
+		{
+		case SSE2: return "SSE2";
+		case SSSE3: return "SSSE3";
+		case AVX2: return "AVX2";
+		default: return "escalar";
+		}
+	}
+
+	inline Isa detectIsa()
+	{
+#ifdef PIXELOPS_X86
+		static const Isa isa = []()
+		{
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2")) return AVX2;
+			if (__builtin_cpu_supports("ssse3")) return SSSE3;
+			if (__builtin_cpu_supports("sse2")) return SSE2;
+			return SCALAR;
+		}();
+		return isa;
+#else
+		return SCALAR;
+#endif
+	}
+
+	// c * a / 255 com arredondamento exato (c, a em [0, 255])
+	inline uint8_t mulDiv255(unsigned c, unsigned a)
+	{
+		unsigned x = c * a + 128;
+		return (uint8_t)((x + (x >> 8)) >> 8);
+	}
+
+	// ------------------------------------------------------------------------
+	// Versões escalares (também tratam o "resto" dos laços SIMD)
+
+	inline void premultiplyScalar(uint8_t* rgba, size_t n)
+	{
+		for (size_t i = 0; i < n; i++, rgba += 4)
+		{
+			unsigned a = rgba[3];
+			rgba[0] = mulDiv255(rgba[0], a);
+			rgba[1] = mulDiv255(rgba[1], a);
+			rgba[2] = mulDiv255(rgba[2], a);
+		}
+	}
+
+	inline void swapRBScalar(uint8_t* px, size_t n)
+	{
+		for (size_t i = 0; i < n; i++, px += 4)
+		{
+			uint8_t r = px[0];
+			px[0] = px[2];
+			px[2] = r;
+		}
+	}
+
+	inline void expandRGBScalar(const uint8_t* rgb, uint8_t* rgba, size_t n)
+	{
+		for (size_t i = 0; i < n; i++, rgb += 3, rgba += 4)
+		{
+			rgba[0] = rgb[0];
+			rgba[1] = rgb[1];
+			rgba[2] = rgb[2];
+			rgba[3] = 255;
+		}
+	}
+
+#ifdef PIXELOPS_X86
+	// ------------------------------------------------------------------------
+	// SSE2: 4 pixels por iteração
+
+	__attribute__((target("sse2")))
+	inline void premultiplySSE2(uint8_t* rgba, size_t n)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i round = _mm_set1_epi16(128);
+		const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			__m128i px = _mm_loadu_si128((const __m128i*)(rgba + 4 * i));
+			// Bytes -> palavras de 16 bits (2 pixels em cada registrador)
+			__m128i lo = _mm_unpacklo_epi8(px, zero);
+			__m128i hi = _mm_unpackhi_epi8(px, zero);
+			// Replica o alfa de cada pixel nos seus 4 canais
+			__m128i alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF), 0xFF);
+			__m128i ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF), 0xFF);
+			// x = c * a + 128; resultado = (x + (x >> 8)) >> 8
+			lo = _mm_add_epi16(_mm_mullo_epi16(lo, alo), round);
+			hi = _mm_add_epi16(_mm_mullo_epi16(hi, ahi), round);
+			lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+			hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+			__m128i res = _mm_packus_epi16(lo, hi);
+			// O canal alfa é mantido como estava
+			res = _mm_or_si128(_mm_andnot_si128(alphaMask, res), _mm_and_si128(alphaMask, px));
+			_mm_storeu_si128((__m128i*)(rgba + 4 * i), res);
+		}
+		premultiplyScalar(rgba + 4 * i, n - i);
+	}
+
+	__attribute__((target("sse2")))
+	inline void swapRBSSE2(uint8_t* px, size_t n)
+	{
+		const __m128i gaMask = _mm_set1_epi32((int)0xFF00FF00);
+		const __m128i rbMask = _mm_set1_epi32(0x00FF00FF);
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*)(px + 4 * i));
+			__m128i ga = _mm_and_si128(v, gaMask);
+			__m128i rb = _mm_and_si128(v, rbMask);
+			// Em cada pixel (32 bits), R está nos bits 0-7 e B nos bits 16-23
+			rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+			_mm_storeu_si128((__m128i*)(px + 4 * i), _mm_or_si128(ga, rb));
+		}
+		swapRBScalar(px + 4 * i, n - i);
+	}
+
+	// ------------------------------------------------------------------------
+	// SSSE3: a expansão RGB -> RGBA precisa do pshufb
+
+	__attribute__((target("ssse3")))
+	inline void expandRGBSSSE3(const uint8_t* rgb, uint8_t* rgba, size_t n)
+	{
+		const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+		const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+		size_t i = 0;
+		// Cada carga lê 16 bytes mas só usa 12: garante que não passa do fim do buffer
+		for (; i + 6 <= n; i += 4)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*)(rgb + 3 * i));
+			v = _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha);
+			_mm_storeu_si128((__m128i*)(rgba + 4 * i), v);
+		}
+		expandRGBScalar(rgb + 3 * i, rgba + 4 * i, n - i);
+	}
+
+	// ------------------------------------------------------------------------
+	// AVX2: 8 pixels por iteração
+
+	__attribute__((target("avx2")))
+	inline void premultiplyAVX2(uint8_t* rgba, size_t n)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i round = _mm256_set1_epi16(128);
+		const __m256i alphaMask = _mm256_set1_epi32((int)0xFF000000);
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8)
+		{
+			__m256i px = _mm256_loadu_si256((const __m256i*)(rgba + 4 * i));
+			// unpack/pack trabalham dentro de cada metade de 128 bits, então a ordem se mantém
+			__m256i lo = _mm256_unpacklo_epi8(px, zero);
+			__m256i hi = _mm256_unpackhi_epi8(px, zero);
+			__m256i alo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, 0xFF), 0xFF);
+			__m256i ahi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, 0xFF), 0xFF);
+			lo = _mm256_add_epi16(_mm256_mullo_epi16(lo, alo), round);
+			hi = _mm256_add_epi16(_mm256_mullo_epi16(hi, ahi), round);
+			lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+			hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+			__m256i res = _mm256_packus_epi16(lo, hi);
+			res = _mm256_blendv_epi8(res, px, alphaMask);
+			_mm256_storeu_si256((__m256i*)(rgba + 4 * i), res);
+		}
+		premultiplySSE2(rgba + 4 * i, n - i);
+	}
+
+	__attribute__((target("avx2")))
+	inline void swapRBAVX2(uint8_t* px, size_t n)
+	{
+		const __m256i shuffle = _mm256_setr_epi8(
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8)
+		{
+			__m256i v = _mm256_loadu_si256((const __m256i*)(px + 4 * i));
+			_mm256_storeu_si256((__m256i*)(px + 4 * i), _mm256_shuffle_epi8(v, shuffle));
+		}
+		swapRBSSE2(px + 4 * i, n - i);
+	}
+
+	__attribute__((target("avx2")))
+	inline void expandRGBAVX2(const uint8_t* rgb, uint8_t* rgba, size_t n)
+	{
+		const __m256i shuffle = _mm256_setr_epi8(
+			0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+			0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+		const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+		size_t i = 0;
+		// A segunda carga começa no byte 12 e lê 16 bytes (28 bytes = 9,33 pixels)
+		for (; i + 10 <= n; i += 8)
+		{
+			__m128i a = _mm_loadu_si128((const __m128i*)(rgb + 3 * i));
+			__m128i b = _mm_loadu_si128((const __m128i*)(rgb + 3 * i + 12));
+			__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(a), b, 1);
+			v = _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), alpha);
+			_mm256_storeu_si256((__m256i*)(rgba + 4 * i), v);
+		}
+		expandRGBSSSE3(rgb + 3 * i, rgba + 4 * i, n - i);
+	}
+#endif
+
+	// ------------------------------------------------------------------------
+	// Despacho conforme o conjunto de instruções
+
+	inline void premultiply(uint8_t* rgba, size_t n, Isa isa = detectIsa())
+	{
+#ifdef PIXELOPS_X86
+		if (isa >= AVX2) { premultiplyAVX2(rgba, n); return; }
+		if (isa >= SSE2) { premultiplySSE2(rgba, n); return; }
+#endif
+		premultiplyScalar(rgba, n);
+	}
+
+	inline void swapRB(uint8_t* px, size_t n, Isa isa = detectIsa())
+	{
+#ifdef PIXELOPS_X86
+		if (isa >= AVX2) { swapRBAVX2(px, n); return; }
+		if (isa >= SSE2) { swapRBSSE2(px, n); return; }
+#endif
+		swapRBScalar(px, n);
+	}
+
+	inline void expandRGB(const uint8_t* rgb, uint8_t* rgba, size_t n, Isa isa = detectIsa())
+	{
+#ifdef PIXELOPS_X86
+		if (isa >= AVX2) { expandRGBAVX2(rgb, rgba, n); return; }
+		if (isa >= SSSE3) { expandRGBSSSE3(rgb, rgba, n); return; }
+#endif
+		expandRGBScalar(rgb, rgba, n);
+	}
+
+	// ------------------------------------------------------------------------
+	// Estágio completo usado pelo loadTexture
+
+	struct Stats
+	{
+		size_t pixels = 0;
+		double seconds = 0.0;
+
+		double mpixPerSec() const { return seconds > 0.0 ? pixels / seconds / 1.0e6 : 0.0; }
+	};
+
+	// Converte a saída do stbi_load (1 a 4 canais) para 4 canais com alfa pré-multiplicado,
+	// em ordem BGRA se bgra for true. Imagens de 4 canais são processadas no próprio buffer
+	// do stb; as demais são expandidas em scratch. Retorna o ponteiro para os pixels prontos.
+	inline uint8_t* prepareTexture(uint8_t* data, int width, int height, int channels, bool bgra,
+		std::vector<uint8_t>& scratch, Stats* stats = nullptr)
+	{
+		auto start = std::chrono::steady_clock::now();
+		size_t n = (size_t)width * (size_t)height;
+		uint8_t* out = data;
+
+		if (channels == 4)
+		{
+			premultiply(out, n);
+		}
+		else
+		{
+			scratch.resize(n * 4);
+			out = scratch.data();
+			if (channels == 3)
+			{
+				// Sem alfa: a pré-multiplicação não altera nada
+				expandRGB(data, out, n);
+			}
+			else
+			{
+				// Tons de cinza (1 canal) ou cinza + alfa (2 canais)
+				for (size_t i = 0; i < n; i++)
+				{
+					uint8_t g = data[i * channels];
+					uint8_t a = channels == 2 ? data[i * channels + 1] : 255;
+					g = mulDiv255(g, a);
+					out[4 * i + 0] = g;
+					out[4 * i + 1] = g;
+					out[4 * i + 2] = g;
+					out[4 * i + 3] = a;
+				}
+			}
+		}
+
+		if (bgra)
+		{
+			swapRB(out, n);
+		}
+
+		if (stats)
+		{
+			stats->pixels = n;
+			stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+		return out;
+	}
+
+	// ------------------------------------------------------------------------
+	// Benchmark (Textures.exe --bench): vazão de cada kernel em MPix/s
+
+	inline void benchmark(size_t n = 4096 * 4096, int repetitions = 10)
+	{
+		std::vector<uint8_t> rgb(n * 3), rgba(n * 4);
+		for (size_t i = 0; i < rgb.size(); i++) rgb[i] = (uint8_t)(rand() & 0xFF);
+		for (size_t i = 0; i < rgba.size(); i++) rgba[i] = (uint8_t)(rand() & 0xFF);
+
+		auto measure = [&](const char* name, Isa isa, auto kernel)
+		{
+			auto start = std::chrono::steady_clock::now();
+			for (int r = 0; r < repetitions; r++)
+			{
+				kernel(isa);
+			}
+			double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::cout << "  " << name << " [" << isaName(isa) << "]: "
+				<< (double)n * repetitions / s / 1.0e6 << " MPix/s" << std::endl;
+		};
+
+		std::cout << "PixelOps: " << n << " pixels, " << repetitions << " repeticoes" << std::endl;
+		Isa best = detectIsa();
+		for (Isa isa : { SCALAR, best })
+		{
+			measure("premultiply", isa, [&](Isa i) { premultiply(rgba.data(), n, i); });
+			measure("swapRB     ", isa, [&](Isa i) { swapRB(rgba.data(), n, i); });
+			measure("expandRGB  ", isa, [&](Isa i) { expandRGB(rgb.data(), rgba.data(), n, i); });
+		}
+	}
+}
@@ -0,0 +1,114 @@
+// Quads indexados com vértices compactos, para sprites e tiles
+// Cada quad tem 4 vértices de 12 bytes: posição x, y em float (o z = 0 e o w = 1 vêm do
+// padrão do atributo) e coordenadas de textura s, t em unorm16 (glm::packUnorm2x16).
+// Os dois triângulos saem de um único buffer de índices, o mesmo para todos os VAOs, com o
+// padrão 0 1 2, 1 3 2 repetido para cada quad; o quad q de um VAO é desenhado com
+// glDrawElementsBaseVertex e base 4 * q. Por quad: 48 bytes contra os 120 de 6 vértices
+// com 5 floats (x, y, z, s, t).
+// Ordem dos cantos: (xMin, yMax), (xMin, yMin), (xMax, yMax), (xMax, yMin), com a mesma
+// orientação dos triângulos de antes.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+//GLAD
+#include <glad/glad.h>
+
+//GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+struct QuadVertex
+{
+	GLfloat x, y;
+	GLuint st; // s nos 16 bits baixos, t nos altos (unorm16)
+};
+
+static_assert(sizeof(QuadVertex) == 12, "QuadVertex com preenchimento");
+
+namespace QuadMesh
+{
+	// Índices de 16 bits: até 65536 vértices (16384 quads) por draw call
+	const size_t MAX_QUADS_PER_DRAW = 65536 / 4;
+
+	inline QuadVertex vertex(float x, float y, float s, float t)
+	{
+		return QuadVertex{ x, y, glm::packUnorm2x16(glm::vec2(s, t)) };
+	}
+
+	// Acrescenta os 4 cantos de um quad
+	inline void append(std::vector<QuadVertex>& vertices, float xMin, float yMin, float xMax, float yMax,
+		float sMin, float tMin, float sMax, float tMax)
+	{
+		vertices.push_back(vertex(xMin, yMax, sMin, tMax));
+		vertices.push_back(vertex(xMin, yMin, sMin, tMin));
+		vertices.push_back(vertex(xMax, yMax, sMax, tMax));
+		vertices.push_back(vertex(xMax, yMin, sMax, tMin));
+	}
+
+	// Buffer de índices compartilhado, criado na primeira chamada
+	inline GLuint indexBuffer()
+	{
+		static GLuint EBO = 0;
+		if (EBO == 0)
+		{
+			std::vector<GLushort> indices;
+			indices.reserve(6 * MAX_QUADS_PER_DRAW);
+			for (size_t q = 0; q < MAX_QUADS_PER_DRAW; q++)
+			{
+				GLushort v = (GLushort)(4 * q);
+				GLushort quad[] = { v, (GLushort)(v + 1), (GLushort)(v + 2), (GLushort)(v + 1), (GLushort)(v + 3), (GLushort)(v + 2) };
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+			// GL_COPY_WRITE_BUFFER: não mexe no buffer de índices do VAO que estiver vinculado
+			glGenBuffers(1, &EBO);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+			glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		}
+		return EBO;
+	}
+
+	// Configura o VAO vinculado: atributos 0 (posição) e 1 (coordenadas de textura) a partir
+	// do VBO vinculado em GL_ARRAY_BUFFER, e o buffer de índices compartilhado
+	inline void setupAttributes()
+	{
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(QuadVertex), (GLvoid*)offsetof(QuadVertex, x));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(QuadVertex), (GLvoid*)offsetof(QuadVertex, st));
+		glEnableVertexAttribArray(1);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer());
+	}
+
+	// Cria VAO e VBO com os vértices (estáticos)
+	inline GLuint createVAO(const std::vector<QuadVertex>& vertices)
+	{
+		GLuint VBO, VAO;
+		glGenBuffers(1, &VBO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(QuadVertex), vertices.data(), GL_STATIC_DRAW);
+
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+		setupAttributes();
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		return VAO;
+	}
+
+	// Desenha os quads [firstQuad, firstQuad + quads) do VAO vinculado
+	inline void draw(size_t firstQuad, size_t quads)
+	{
+		while (quads > 0)
+		{
+			size_t n = std::min(quads, MAX_QUADS_PER_DRAW);
+			glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)(6 * n), GL_UNSIGNED_SHORT, (GLvoid*)0, (GLint)(4 * firstQuad));
+			firstQuad += n;
+			quads -= n;
+		}
+	}
+}
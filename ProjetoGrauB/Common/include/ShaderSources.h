@@ -0,0 +1,129 @@
+// Código fonte GLSL compartilhado por todos os programas
+// Cada entrada é um "arquivo" com nome, que pode ser incluído pelos outros com
+// #include "nome" (ver ShaderVariants.h). Os shaders de sprite são escritos uma vez só e
+// as variações (textura, animação da spritesheet, instancing, cor por vértice) saem de
+// blocos #ifdef, ligados pelos #defines de cada variante.
+//
+// Atributos de vértice usados pelos shaders de sprite:
+//   0 position (vec3)        sempre
+//   1 texc (vec2)            TEXTURED
+//   2 vertexColor (vec4)     VERTEX_COLOR
+//   3 instanceOffset (vec3)  INSTANCED, um por instância (somado depois do model)
+//   4 instanceColor (vec4)   INSTANCED, um por instância
+//
+// Os shaders de tilemap desenham o mapa inteiro com um quad de 0 a 1 (atributo 0): o índice
+// de cada tile vem de uma textura de inteiros e a cor, da paleta (ver TileMap.h).
+
+#pragma once
+
+namespace ShaderSources
+{
+	struct Source
+	{
+		const char* name;
+		const char* code;
+	};
+
+	// Bloco uniforme com câmera e dados do frame (ver FrameUniforms.h)
+	const char* const FRAME_DATA = R"(layout (std140) uniform FrameData
+{
+	mat4 projection;
+	mat4 view;
+	vec2 viewport;
+	float time;
+};
+)";
+
+	const char* const SPRITE_VS = R"(#version 400
+#include "frame_data.glsl"
+uniform mat4 model;
+layout (location = 0) in vec3 position;
+#ifdef TEXTURED
+layout (location = 1) in vec2 texc;
+out vec2 texCoord;
+#endif
+#ifdef VERTEX_COLOR
+layout (location = 2) in vec4 vertexColor;
+#endif
+#ifdef INSTANCED
+layout (location = 3) in vec3 instanceOffset;
+layout (location = 4) in vec4 instanceColor;
+#endif
+out vec4 tint;
+void main()
+{
+	vec4 worldPosition = model * vec4(position, 1.0);
+	tint = vec4(1.0);
+#ifdef VERTEX_COLOR
+	tint *= vertexColor;
+#endif
+#ifdef INSTANCED
+	worldPosition.xyz += instanceOffset;
+	tint *= instanceColor;
+#endif
+	gl_Position = projection * view * worldPosition;
+#ifdef TEXTURED
+	texCoord = vec2(texc.s, 1.0 - texc.t);
+#endif
+}
+)";
+
+	const char* const SPRITE_FS = R"(#version 400
+in vec4 tint;
+#ifdef TEXTURED
+in vec2 texCoord;
+uniform sampler2D texBuff;
+#ifdef ANIMATED
+uniform vec2 offsetTex;
+#endif
+#else
+uniform vec4 inputColor;
+#endif
+out vec4 color;
+void main()
+{
+#if defined(TEXTURED) && defined(ANIMATED)
+	color = texture(texBuff, texCoord + offsetTex);
+#elif defined(TEXTURED)
+	color = texture(texBuff, texCoord);
+#else
+	color = inputColor;
+#endif
+	color *= tint;
+}
+)";
+
+	const char* const TILEMAP_VS = R"(#version 400
+#include "frame_data.glsl"
+uniform mat4 model;
+uniform vec2 mapSize;
+layout (location = 0) in vec3 position;
+out vec2 mapCoord;
+void main()
+{
+	mapCoord = position.xy * mapSize;
+	gl_Position = projection * view * model * vec4(position, 1.0);
+}
+)";
+
+	const char* const TILEMAP_FS = R"(#version 400
+in vec2 mapCoord;
+uniform usampler2D tiles;
+uniform sampler2D palette;
+out vec4 color;
+void main()
+{
+	ivec2 cell = clamp(ivec2(floor(mapCoord)), ivec2(0), textureSize(tiles, 0) - 1);
+	uint index = texelFetch(tiles, cell, 0).r;
+	color = texelFetch(palette, ivec2(int(index), 0), 0);
+}
+)";
+
+	const Source ALL[] = {
+		{ "frame_data.glsl", FRAME_DATA },
+		{ "sprite.vs", SPRITE_VS },
+		{ "sprite.fs", SPRITE_FS },
+		{ "tilemap.vs", TILEMAP_VS },
+		{ "tilemap.fs", TILEMAP_FS },
+	};
+}
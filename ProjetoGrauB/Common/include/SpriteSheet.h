@@ -0,0 +1,257 @@
+// Descrição de spritesheet com frames recortados (trimmed)
+// Cada frame guarda só o retângulo com pixels visíveis e a posição do pivô (a origem
+// da sprite) dentro dele, então frames de tamanhos diferentes podem dividir a mesma
+// folha e o quad desenhado cobre só o que aparece.
+//
+// Forma texto (editável), uma entrada por linha, '#' inicia comentário:
+//   sheet <largura> <altura>                 dimensões da textura em pixels
+//   anim <nome> <primeiro frame> <nFrames>   animação = sequência de frames
+//   frame <x> <y> <w> <h> <pivoX> <pivoY>    retângulo (origem no canto superior
+//                                            esquerdo da imagem) e pivô relativo a ele
+// Forma binária: o mesmo conteúdo em registros de tamanho fixo (ver SheetHeader),
+// gerada a partir do texto por loadCached() sempre que o texto for mais novo.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+//GLAD
+#include <glad/glad.h>
+
+#include "QuadMesh.h"
+
+class SpriteSheet
+{
+public:
+	struct Frame
+	{
+		uint16_t x, y, w, h;  // retângulo recortado, em pixels
+		float pivotX, pivotY; // origem da sprite medida a partir do canto superior esquerdo do retângulo
+	};
+
+	struct Animation
+	{
+		char name[16];
+		uint16_t firstFrame, nFrames;
+	};
+
+	int width = 0, height = 0;
+	std::vector<Frame> frames;
+	std::vector<Animation> animations;
+
+	// Lê a forma texto
+	bool loadText(const std::string& path)
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			std::cout << "ERROR::SPRITESHEET::FILE_NOT_SUCCESFULLY_READ " << path << std::endl;
+			return false;
+		}
+
+		clear();
+		std::string line;
+		int lineNumber = 0;
+		while (std::getline(file, line))
+		{
+			lineNumber++;
+			line = line.substr(0, line.find('#'));
+			std::istringstream in(line);
+			std::string key;
+			if (!(in >> key))
+			{
+				continue;
+			}
+
+			bool ok = true;
+			if (key == "sheet")
+			{
+				ok = (bool)(in >> width >> height);
+			}
+			else if (key == "anim")
+			{
+				std::string name;
+				int first, n;
+				ok = (bool)(in >> name >> first >> n);
+				Animation anim = {};
+				strncpy(anim.name, name.c_str(), sizeof(anim.name) - 1);
+				anim.firstFrame = (uint16_t)first;
+				anim.nFrames = (uint16_t)n;
+				animations.push_back(anim);
+			}
+			else if (key == "frame")
+			{
+				int x, y, w, h;
+				Frame frame;
+				ok = (bool)(in >> x >> y >> w >> h >> frame.pivotX >> frame.pivotY);
+				frame.x = (uint16_t)x;
+				frame.y = (uint16_t)y;
+				frame.w = (uint16_t)w;
+				frame.h = (uint16_t)h;
+				frames.push_back(frame);
+			}
+			else
+			{
+				ok = false;
+			}
+
+			if (!ok)
+			{
+				std::cout << "ERROR::SPRITESHEET::PARSE " << path << ":" << lineNumber << ": " << line << std::endl;
+				return false;
+			}
+		}
+		return validate(path);
+	}
+
+	// Lê a forma binária
+	bool loadBinary(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		SheetHeader header;
+		if (!file || !file.read((char*)&header, sizeof(header)) || memcmp(header.magic, "SPSH", 4) != 0
+			|| header.version != VERSION)
+		{
+			return false;
+		}
+
+		clear();
+		width = header.width;
+		height = header.height;
+		frames.resize(header.nFrames);
+		animations.resize(header.nAnimations);
+		file.read((char*)frames.data(), frames.size() * sizeof(Frame));
+		file.read((char*)animations.data(), animations.size() * sizeof(Animation));
+		return (bool)file && validate(path);
+	}
+
+	// Grava a forma binária
+	bool saveBinary(const std::string& path) const
+	{
+		std::ofstream file(path, std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+		SheetHeader header = {};
+		memcpy(header.magic, "SPSH", 4);
+		header.version = VERSION;
+		header.width = (uint16_t)width;
+		header.height = (uint16_t)height;
+		header.nFrames = (uint16_t)frames.size();
+		header.nAnimations = (uint16_t)animations.size();
+		file.write((const char*)&header, sizeof(header));
+		file.write((const char*)frames.data(), frames.size() * sizeof(Frame));
+		file.write((const char*)animations.data(), animations.size() * sizeof(Animation));
+		return (bool)file;
+	}
+
+	// Usa o binário se ele estiver atualizado; senão lê o texto e regrava o binário
+	bool loadCached(const std::string& textPath, const std::string& binaryPath)
+	{
+		std::error_code ec;
+		auto textTime = std::filesystem::last_write_time(textPath, ec);
+		bool textOk = !ec;
+		auto binaryTime = std::filesystem::last_write_time(binaryPath, ec);
+		bool binaryFresh = !ec && (!textOk || binaryTime >= textTime);
+
+		if (binaryFresh && loadBinary(binaryPath))
+		{
+			return true;
+		}
+		if (!loadText(textPath))
+		{
+			return false;
+		}
+		if (!saveBinary(binaryPath))
+		{
+			std::cout << "ERROR::SPRITESHEET::WRITE " << binaryPath << std::endl;
+		}
+		return true;
+	}
+
+	int findAnimation(const std::string& name) const
+	{
+		for (size_t i = 0; i < animations.size(); i++)
+		{
+			if (name == animations[i].name)
+			{
+				return (int)i;
+			}
+		}
+		return -1;
+	}
+
+	// Cria o VAO com um quad justo por frame (6 vértices x, y, z, s, t), em pixels e com a
+	// origem no pivô. O frame i é desenhado com glDrawArrays(GL_TRIANGLES, 6 * i, 6)
+	GLuint createVAO() const
+	{
+		std::vector<QuadVertex> vertices;
+		vertices.reserve(frames.size() * 4);
+		for (const Frame& f : frames)
+		{
+			float xMin = -f.pivotX, xMax = f.w - f.pivotX;
+			float yMax = f.pivotY, yMin = f.pivotY - f.h;
+
+			// O vertex shader inverte t (texCoord.t = 1 - t)
+			float sMin = f.x / (float)width, sMax = (f.x + f.w) / (float)width;
+			float tMax = 1.0f - f.y / (float)height, tMin = 1.0f - (f.y + f.h) / (float)height;
+
+			QuadMesh::append(vertices, xMin, yMin, xMax, yMax, sMin, tMin, sMax, tMax);
+		}
+
+		return QuadMesh::createVAO(vertices);
+	}
+
+private:
+	static const uint16_t VERSION = 1;
+
+	struct SheetHeader
+	{
+		char magic[4];
+		uint16_t version;
+		uint16_t width, height;
+		uint16_t nFrames, nAnimations;
+		uint16_t reserved;
+	};
+
+	void clear()
+	{
+		width = height = 0;
+		frames.clear();
+		animations.clear();
+	}
+
+	bool validate(const std::string& path) const
+	{
+		if (width <= 0 || height <= 0)
+		{
+			std::cout << "ERROR::SPRITESHEET::MISSING_SHEET_SIZE " << path << std::endl;
+			return false;
+		}
+		for (const Frame& f : frames)
+		{
+			if (f.x + f.w > width || f.y + f.h > height)
+			{
+				std::cout << "ERROR::SPRITESHEET::FRAME_OUT_OF_BOUNDS " << path << std::endl;
+				return false;
+			}
+		}
+		for (const Animation& a : animations)
+		{
+			if (a.nFrames == 0 || a.firstFrame + a.nFrames > frames.size())
+			{
+				std::cout << "ERROR::SPRITESHEET::BAD_ANIMATION " << a.name << " em " << path << std::endl;
+				return false;
+			}
+		}
+		return true;
+	}
+};
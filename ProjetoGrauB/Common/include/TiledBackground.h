@@ -0,0 +1,323 @@
+// Camada de fundo em tiles, para imagens maiores que a tela (ou que GL_MAX_TEXTURE_SIZE)
+// A imagem é cortada em tiles de tamanho fixo. Só os tiles que intersectam a área visível
+// (mais uma margem de pré-carga) são enviados para uma textura de cache (atlas); quando o
+// orçamento de memória do atlas acaba, o tile usado há mais tempo (LRU) é descartado.
+// O desenho é feito com um único draw call, usando o mesmo shader das sprites.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+//GLAD
+#include <glad/glad.h>
+
+//GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+// STB_IMAGE
+#include <stb_image.h>
+
+#include "PixelOps.h"
+#include "QuadMesh.h"
+#include "Shader.h"
+
+class TiledBackground
+{
+public:
+	// Estatísticas do último update()
+	struct Stats
+	{
+		int visibleTiles = 0;   // tiles na área visível (desenhados)
+		int requestedTiles = 0; // visíveis + margem de pré-carga
+		int uploads = 0;        // tiles enviados para a GPU neste frame
+		int evictions = 0;      // tiles descartados neste frame
+		int residentTiles = 0;  // tiles presentes no atlas
+		size_t residentBytes = 0;
+		size_t budgetBytes = 0;
+	};
+
+	Stats stats;
+
+	// tileSize: lado do tile em pixels da imagem
+	// scale: pixels de tela por pixel da imagem
+	// origin: canto inferior esquerdo da imagem no mundo
+	// memoryBudget: bytes máximos do atlas de cache
+	// prefetch: margem de pré-carga, em tiles, ao redor da área visível
+	bool load(const std::string& filePath, int tileSize, float scale, glm::vec2 origin,
+		size_t memoryBudget, int prefetch = 1)
+	{
+		// Uma nova imagem substitui a anterior: libera o atlas e os buffers dela
+		release();
+
+		this->tileSize = tileSize;
+		this->scale = scale;
+		this->origin = origin;
+		this->prefetch = prefetch;
+
+		int nrChannels;
+		unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
+		if (!data)
+		{
+			std::cout << "Failed to load texture" << filePath << std::endl;
+			return false;
+		}
+
+		// A imagem decodificada fica na memória do sistema, já no formato de upload;
+		// a GPU só recebe os tiles que aparecem na tela
+		std::vector<unsigned char> scratch;
+		unsigned char* ready = PixelOps::prepareTexture(data, width, height, nrChannels, true, scratch);
+		pixels.assign(ready, ready + (size_t)width * height * 4);
+		stbi_image_free(data);
+
+		tilesX = (width + tileSize - 1) / tileSize;
+		tilesY = (height + tileSize - 1) / tileSize;
+
+		// Quantos tiles cabem no orçamento e no tamanho máximo de textura
+		GLint maxTexSize;
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTexSize);
+		size_t tileBytes = (size_t)tileSize * tileSize * 4;
+		int maxSlotsPerRow = std::max(1, maxTexSize / tileSize);
+		int nSlots = (int)std::max<size_t>(1, memoryBudget / tileBytes);
+		nSlots = std::min(nSlots, tilesX * tilesY);
+		nSlots = std::min(nSlots, maxSlotsPerRow * maxSlotsPerRow);
+
+		slotsX = std::min(nSlots, std::min(maxSlotsPerRow, (int)std::ceil(std::sqrt((double)nSlots))));
+		slotsY = std::min(maxSlotsPerRow, nSlots / slotsX);
+		nSlots = slotsX * slotsY; // arredonda para baixo, para não passar do orçamento
+
+		slots.assign(nSlots, Slot());
+		lru.clear();
+		for (int i = 0; i < nSlots; i++)
+		{
+			slots[i].lruPos = lru.insert(lru.end(), i);
+		}
+		tileToSlot.clear();
+		stats = Stats();
+		stats.budgetBytes = (size_t)nSlots * tileBytes;
+
+		// Atlas de cache: sem mipmaps (os tiles são vizinhos) e com filtro NEAREST
+		glGenTextures(1, &atlasID);
+		glBindTexture(GL_TEXTURE_2D, atlasID);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, slotsX * tileSize, slotsY * tileSize, 0, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// Buffer de vértices atualizado a cada frame (quads indexados, ver QuadMesh.h)
+		glGenBuffers(1, &VBO);
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		QuadMesh::setupAttributes();
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		std::cout << filePath << ": " << width << "x" << height << " em " << tilesX << "x" << tilesY
+			<< " tiles de " << tileSize << "px, cache de " << nSlots << " tiles ("
+			<< stats.budgetBytes / 1024 << " KB)" << std::endl;
+		return true;
+	}
+
+	// Apaga a textura de atlas e os buffers (load chama antes de criar os novos)
+	void release()
+	{
+		if (atlasID)
+		{
+			glDeleteTextures(1, &atlasID);
+			atlasID = 0;
+		}
+		if (VAO)
+		{
+			glDeleteVertexArrays(1, &VAO);
+			VAO = 0;
+		}
+		if (VBO)
+		{
+			glDeleteBuffers(1, &VBO);
+			VBO = 0;
+		}
+	}
+
+	// Garante que os tiles da área visível (em coordenadas de mundo) estão no atlas
+	// e monta a geometria deles
+	void update(glm::vec2 viewMin, glm::vec2 viewMax)
+	{
+		frame++;
+		stats.uploads = 0;
+		stats.evictions = 0;
+		stats.visibleTiles = 0;
+		stats.requestedTiles = 0;
+		vertices.clear();
+
+		int x0, y0, x1, y1;
+		tileRange(viewMin, viewMax, x0, y0, x1, y1);
+
+		// Primeiro os tiles visíveis, para que a pré-carga nunca tire o lugar deles
+		for (int ty = y0; ty <= y1; ty++)
+		{
+			for (int tx = x0; tx <= x1; tx++)
+			{
+				int slot = request(tx, ty);
+				stats.visibleTiles++;
+				if (slot >= 0)
+				{
+					appendQuad(tx, ty, slot);
+				}
+			}
+		}
+
+		// Margem de pré-carga
+		for (int ty = std::max(0, y0 - prefetch); ty <= std::min(tilesY - 1, y1 + prefetch); ty++)
+		{
+			for (int tx = std::max(0, x0 - prefetch); tx <= std::min(tilesX - 1, x1 + prefetch); tx++)
+			{
+				if (tx < x0 || tx > x1 || ty < y0 || ty > y1)
+				{
+					request(tx, ty);
+				}
+			}
+		}
+
+		stats.residentTiles = (int)tileToSlot.size();
+		stats.residentBytes = (size_t)stats.residentTiles * tileSize * tileSize * 4;
+	}
+
+	// Desenha os tiles visíveis com o shader das sprites (model = identidade, offsetTex = 0)
+	void draw(const Shader& shader)
+	{
+		if (vertices.empty())
+		{
+			return;
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(QuadVertex), vertices.data(), GL_STREAM_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		glm::mat4 model = glm::mat4(1);
+		shader.setMat4("model", glm::value_ptr(model));
+		shader.setVec2("offsetTex", 0.0, 0.0);
+
+		glBindVertexArray(VAO);
+		glBindTexture(GL_TEXTURE_2D, atlasID);
+		QuadMesh::draw(0, vertices.size() / 4);
+		glBindVertexArray(0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+private:
+	struct Slot
+	{
+		int tile = -1;           // índice do tile armazenado (-1 = livre)
+		unsigned lastFrame = 0;  // último frame em que foi usado
+		std::list<int>::iterator lruPos;
+	};
+
+	int width = 0, height = 0;
+	int tileSize = 0, tilesX = 0, tilesY = 0;
+	int slotsX = 0, slotsY = 0;
+	int prefetch = 1;
+	float scale = 1.0f;
+	glm::vec2 origin;
+	unsigned frame = 0;
+
+	std::vector<unsigned char> pixels;
+	std::vector<Slot> slots;
+	std::list<int> lru; // frente = usado mais recentemente
+	std::unordered_map<int, int> tileToSlot;
+	std::vector<QuadVertex> vertices;
+
+	GLuint atlasID = 0, VAO = 0, VBO = 0;
+
+	// Intervalo de tiles (linhas contadas a partir do topo da imagem) que cobre a área
+	void tileRange(glm::vec2 viewMin, glm::vec2 viewMax, int& x0, int& y0, int& x1, int& y1) const
+	{
+		float worldTile = tileSize * scale;
+		float top = origin.y + height * scale;
+		x0 = std::max(0, (int)std::floor((viewMin.x - origin.x) / worldTile));
+		x1 = std::min(tilesX - 1, (int)std::floor((viewMax.x - origin.x) / worldTile));
+		y0 = std::max(0, (int)std::floor((top - viewMax.y) / worldTile));
+		y1 = std::min(tilesY - 1, (int)std::floor((top - viewMin.y) / worldTile));
+	}
+
+	// Retorna o slot do atlas com o tile, enviando-o se necessário (-1 se o cache está cheio)
+	int request(int tx, int ty)
+	{
+		stats.requestedTiles++;
+		int tile = ty * tilesX + tx;
+		auto it = tileToSlot.find(tile);
+		int slot;
+		if (it != tileToSlot.end())
+		{
+			slot = it->second;
+		}
+		else
+		{
+			// O slot menos usado recentemente está no fim da lista
+			slot = lru.back();
+			if (slots[slot].tile >= 0)
+			{
+				if (slots[slot].lastFrame == frame)
+				{
+					return -1; // tudo o que está no cache é usado neste frame
+				}
+				tileToSlot.erase(slots[slot].tile);
+				stats.evictions++;
+			}
+			slots[slot].tile = tile;
+			tileToSlot[tile] = slot;
+			upload(tx, ty, slot);
+		}
+
+		slots[slot].lastFrame = frame;
+		lru.splice(lru.begin(), lru, slots[slot].lruPos);
+		return slot;
+	}
+
+	void upload(int tx, int ty, int slot)
+	{
+		int px = tx * tileSize, py = ty * tileSize;
+		int w = std::min(tileSize, width - px);
+		int h = std::min(tileSize, height - py);
+
+		glBindTexture(GL_TEXTURE_2D, atlasID);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, (slot % slotsX) * tileSize, (slot / slotsX) * tileSize, w, h,
+			GL_BGRA, GL_UNSIGNED_BYTE, pixels.data() + ((size_t)py * width + px) * 4);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		stats.uploads++;
+	}
+
+	void appendQuad(int tx, int ty, int slot)
+	{
+		int px = tx * tileSize, py = ty * tileSize;
+		int w = std::min(tileSize, width - px);
+		int h = std::min(tileSize, height - py);
+
+		// Posição no mundo (y cresce para cima, linhas da imagem crescem para baixo)
+		float xMin = origin.x + px * scale;
+		float xMax = origin.x + (px + w) * scale;
+		float yMax = origin.y + (height - py) * scale;
+		float yMin = origin.y + (height - py - h) * scale;
+
+		// Coordenadas no atlas; o vertex shader inverte t (texCoord.t = 1 - t)
+		float atlasW = (float)(slotsX * tileSize), atlasH = (float)(slotsY * tileSize);
+		float sMin = (slot % slotsX) * tileSize / atlasW;
+		float sMax = sMin + w / atlasW;
+		float vTop = (slot / slotsX) * tileSize / atlasH;
+		float tMax = 1.0f - vTop;
+		float tMin = 1.0f - (vTop + h / atlasH);
+
+		QuadMesh::append(vertices, xMin, yMin, xMax, yMax, sMin, tMin, sMax, tMax);
+	}
+};
@@ -23,6 +23,28 @@ using namespace glm;
 
 #include <cmath>
 
+// Conversão dos pixels na carga das texturas (alfa pré-multiplicado)
+#include "PixelOps.h"
+
+// Fundo dividido em tiles com cache LRU
+#include "TiledBackground.h"
+
+// Spritesheet com frames recortados
+#include "SpriteSheet.h"
+
+// Biblioteca de shaders (compilação assíncrona e cache de binários) e variantes por features
+#include "ShaderLibrary.h"
+#include "ShaderVariants.h"
+
+// Uniform buffer com câmera e dados do frame
+#include "FrameUniforms.h"
+
+// Envio de uniforms sem repetir valores (cópia sombra por programa)
+#include "Shader.h"
+
+// Transformações com pai e filhos, recalculadas só quando mudam
+#include "SceneGraph.h"
+
 // Estrutura de dados das sprites
 struct Sprite
 {
@@ -36,11 +58,18 @@ struct Sprite
 	int iAnimation, iFrame;
 	float ds, dt;
 
+	// Spritesheet descrita por arquivo (nullptr = grade uniforme nAnimations x nFrames)
+	SpriteSheet *sheet;
+	float pixelScale; // pixels de tela por pixel da textura
+
 	// Para a movimentação do sprite
 	float vel;
 
 	// Para a colisão (AABB)
 	vec2 pMax, pMin;
+
+	// Nó no grafo de cena (matriz de modelo)
+	int node;
 };
 
 
@@ -48,19 +77,21 @@ struct Sprite
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
 
 // Protótipos das funções
-int setupShader();
+ShaderFuture setupShader();
 int setupGeometry();
 Sprite initializeSprite(GLuint texID, vec3 dimensions, vec3 position, float vel = 0.2, int nAnimations=1, int nFrames=1, float angle=0.0);
+Sprite initializeSheetSprite(GLuint texID, SpriteSheet &sheet, float pixelScale, vec3 dimensions, vec3 position, float vel = 0.2, float angle=0.0);
 
 GLuint loadTexture(string filePath, int &width, int &height);
 
-void drawTriangle(GLuint shaderID, GLuint VAO, vec3 position, vec3 dimensions, float angle, vec3 color, vec3 axis = (vec3(0.0, 0.0, 1.0)));
-void drawSprite(GLuint shaderID, Sprite &sprite);
-void updateSprite(GLuint shaderID, Sprite &sprite);
-void moveSprite(GLuint shaderID, Sprite &sprite);
+void drawTriangle(Shader &shader, GLuint VAO, vec3 position, vec3 dimensions, float angle, vec3 color, vec3 axis = (vec3(0.0, 0.0, 1.0)));
+void drawSprite(Shader &shader, Sprite &sprite);
+void updateSprite(Shader &shader, Sprite &sprite);
+void moveSprite(Shader &shader, Sprite &sprite);
+void setAnimation(Sprite &sprite, int iAnimation);
 
-void updateSnowball(GLuint shaderID, Sprite &sprite);
-void updateItems(GLuint shaderID, Sprite &sprite);
+void updateSnowball(Shader &shader, Sprite &sprite);
+void updateItems(Shader &shader, Sprite &sprite);
 
 void spawnItem(Sprite &sprite);
 
@@ -70,31 +101,12 @@ bool checkCollision(Sprite &playerSprite, Sprite &itemSprite);
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
 
-// Código fonte do Vertex Shader (em GLSL): ainda hardcoded
-const GLchar* vertexShaderSource = R"(
-#version 400
-layout (location = 0) in vec3 position;
-layout (location = 1) in vec2 texc;
-uniform mat4 projection;
-uniform mat4 model;
-out vec2 texCoord;
-void main()
-{
-	gl_Position = projection * model * vec4(position.x, position.y, position.z, 1.0);
-	texCoord = vec2(texc.s, 1.0-texc.t);
-})";
-
-//Código fonte do Fragment Shader (em GLSL): ainda hardcoded
-const GLchar* fragmentShaderSource = R"(
-#version 400
-in vec2 texCoord;
-uniform sampler2D texBuff;
-uniform vec2 offsetTex;
-out vec4 color;
-void main()
-{
-	color = texture(texBuff, texCoord + offsetTex);
-})";
+// Configuração do fundo em tiles
+const int BACKGROUND_TILE_SIZE = 64; // lado do tile, em pixels da imagem
+const size_t BACKGROUND_BUDGET = 4 * 1024 * 1024; // memória máxima do cache de tiles (bytes)
+
+// Shaders de sprite: um único código fonte (ShaderSources.h), com variantes por features
+ShaderVariants spriteShaders("sprite.vs", "sprite.fs");
 
 // Variáveis globais
 float FPS = 8.0f;
@@ -104,9 +116,20 @@ GLuint itemsTexIDs[5];
 int score = 0;
 int missedItems = 0;
 
+// Transformações das sprites: drawSprite repassa pos, angle e escala a cada frame, e a matriz
+// só é recalculada quando um deles mudou
+SceneGraph scene;
+
 // Função MAIN
-int main()
+int main(int argc, char** argv)
 {
+	// Textures.exe --bench: mede a vazão das operações de pixel e sai
+	if (argc > 1 && string(argv[1]) == "--bench")
+	{
+		PixelOps::benchmark();
+		return 0;
+	}
+
 	srand(time(0)); // Pega o horário do sistema como semente para geração de números aleatórios
 
 	// Inicialização da GLFW
@@ -143,20 +166,33 @@ int main()
 	glfwGetFramebufferSize(window, &width, &height);
 	glViewport(0, 0, width, height);
 
-	// Compilando e buildando o programa de shader
-	GLuint shaderID = setupShader();
+	// Submetendo o programa de shader: ele compila enquanto as texturas são carregadas
+	ShaderFuture shaderFuture = setupShader();
 
 	// Criação dos sprites - objetos da cena
-	Sprite background, character, snowball, item;
+	Sprite character, snowball, item;
+	TiledBackground background;
 	int imgWidth, imgHeight, texID;
 
 	// Carregando a textura do personagem e armazenando seu id
+	// Os frames vêm da descrição da spritesheet (sprite.sheet.txt, convertida para binário)
 	texID = loadTexture("../Textures/sprite.png", imgWidth, imgHeight);
-	character = initializeSprite(texID, vec3(3*imgWidth, 3*imgHeight, 1.0), vec3(400, 100, 0), 0.3, 3, 4);
+	SpriteSheet characterSheet;
+	if (!characterSheet.loadCached("../Textures/sprite.sheet.txt", "../Textures/sprite.sheet") || characterSheet.animations.empty())
+	{
+		std::cout << "ERROR::SPRITESHEET::NO_ANIMATIONS ../Textures/sprite.sheet.txt" << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	// A caixa de colisão continua sendo a célula original de 32x32 (escalada 3x)
+	character = initializeSheetSprite(texID, characterSheet, 3.0, vec3(3*32, 3*32, 1.0), vec3(400, 100, 0), 0.3);
 
-	// Carregando a textura do background e armazenando seu id
-	texID = loadTexture("../Textures/background.png", imgWidth, imgHeight);
-	background = initializeSprite(texID, vec3(2*imgWidth, 2*imgHeight, 1.0), vec3(400, 300, 0));
+	// Carregando o fundo em tiles: escala 2x, canto inferior esquerdo na origem da tela
+	if (!background.load("../Textures/background.png", BACKGROUND_TILE_SIZE, 2.0, vec2(0.0, 0.0), BACKGROUND_BUDGET))
+	{
+		glfwTerminate();
+		return -1;
+	}
 
 	// Carregando as texturas dos itens
 	itemsTexIDs[1] = loadTexture("../Textures/hat.png", imgWidth, imgHeight);
@@ -188,31 +224,44 @@ int main()
 	texID = loadTexture("../Textures/win_screen.png", imgWidth, imgHeight);
 	Sprite gameWin = initializeSprite(texID, vec3(imgWidth * 5, imgHeight * 5, 1.0), vec3(400, 300, 0));
 
-	glUseProgram(shaderID);
+	// Aqui o programa de shader precisa estar pronto
+	// Os uniforms passam pelo Shader, que evita reenviar valores que não mudaram
+	Shader shader(shaderFuture.get());
+	shader.Use();
 
 	// Enviar a informação de qual variável armazenará o buffer da textura
-	//                                                     id do buffer
-	glUniform1i(glGetUniformLocation(shaderID, "texBuff"), 0);
+	//                          id do buffer
+	shader.setInt("texBuff", 0);
 
 	// Ativando o primeiro buffer de textura da OpenGL
 	glActiveTexture(GL_TEXTURE0);
 
+	// Câmera e dados do frame ficam num uniform buffer compartilhado por todos os shaders
+	FrameUniforms frame;
+	frame.init();
+	ShaderLibrary::get().bindUniformBlock("FrameData", FRAME_DATA_BINDING);
+
 	//Matriz de projeção paralela ortográfica
-	//mat4 projection = ortho(-10.0, 10.0, -10.0, 10.0, -1.0, 1.0);
-	mat4 projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);  
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	//frame.data.projection = ortho(-10.0, 10.0, -10.0, 10.0, -1.0, 1.0);
+	frame.data.projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);  
+	frame.data.viewport = vec2(width, height);
 
 	//Matriz de modelo: transformações na geometria (objeto)
 	mat4 model = mat4(1); //matriz identidade
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+	shader.setMat4("model", value_ptr(model));
 
 	// Habilitando o teste de profundidade
 	glEnable(GL_DEPTH_TEST); 
 	glDepthFunc(GL_ALWAYS);
 	
 	// Habilitando a transparência
+	// As texturas são carregadas com alfa pré-multiplicado (ver loadTexture)
 	glEnable(GL_BLEND); 
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+	// Uniforms enviados / evitados, somados e mostrados uma vez por segundo
+	Shader::UniformStats uniformsSinceReport;
+	double uniformReportTime = glfwGetTime();
 
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
@@ -220,6 +269,10 @@ int main()
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
 
+		// Atualiza o bloco FrameData uma única vez por frame
+		frame.data.time = glfwGetTime();
+		frame.update();
+
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); //cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -238,29 +291,29 @@ int main()
 			if (score >= 30)
 			{
 				// Fundo
-				glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), 0.0, 0.0);
-				drawSprite(shaderID, gameWin);
+				shader.setVec2("offsetTex", 0.0, 0.0);
+				drawSprite(shader, gameWin);
 			}
 			else
 			{
-				// Fundo
-				glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), 0.0, 0.0);
-				drawSprite(shaderID, background);
+				// Fundo: só os tiles que aparecem na janela
+				background.update(vec2(0.0, 0.0), vec2(WIDTH, HEIGHT));
+				background.draw(shader);
 			
 				// Personagem
-				moveSprite(shaderID, character);
-				updateSprite(shaderID, character);
-				drawSprite(shaderID, character);
+				moveSprite(shader, character);
+				updateSprite(shader, character);
+				drawSprite(shader, character);
 
 				// Bola de neve
-				glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), 0.0, 0.0);
-				updateSnowball(shaderID, snowball);
-				drawSprite(shaderID, snowball);
+				shader.setVec2("offsetTex", 0.0, 0.0);
+				updateSnowball(shader, snowball);
+				drawSprite(shader, snowball);
 
 				// Itens
-				glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), 0.0, 0.0);
-				updateItems(shaderID, item);
-				drawSprite(shaderID, item);
+				shader.setVec2("offsetTex", 0.0, 0.0);
+				updateItems(shader, item);
+				drawSprite(shader, item);
 			}
 		}
 		else
@@ -268,14 +321,14 @@ int main()
 			if (gameOver)
 			{
 				// Sufocou em neve
-				glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), 0.0, 0.0);
-				drawSprite(shaderID, gameOverSnow);
+				shader.setVec2("offsetTex", 0.0, 0.0);
+				drawSprite(shader, gameOverSnow);
 			}
 			else
 			{
 				// Congelou
-				glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), 0.0, 0.0);
-				drawSprite(shaderID, gameOverCold);
+				shader.setVec2("offsetTex", 0.0, 0.0);
+				drawSprite(shader, gameOverCold);
 			}
 		}
 
@@ -284,6 +337,18 @@ int main()
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
+
+		// Contadores de uniforms enviados / evitados neste frame
+		Shader::UniformStats uniforms = Shader::endFrame();
+		uniformsSinceReport.sent += uniforms.sent;
+		uniformsSinceReport.skipped += uniforms.skipped;
+		if (glfwGetTime() - uniformReportTime >= 1.0)
+		{
+			cout << "Uniforms no ultimo segundo: " << uniformsSinceReport.sent << " enviados, "
+				<< uniformsSinceReport.skipped << " evitados" << endl;
+			uniformsSinceReport = Shader::UniformStats();
+			uniformReportTime = glfwGetTime();
+		}
 	}
 	// Pede pra OpenGL desalocar os buffers
 	//glDeleteVertexArrays(1, character.VAO);
@@ -310,52 +375,13 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 	}
 }
 
-//Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
-// shader simples e único neste exemplo de código
-// O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-// fragmentShader source no iniçio deste arquivo
-// A função retorna o identificador do programa de shader
-int setupShader()
+// Pede a variante do shader de sprite usada neste jogo: textura com deslocamento
+// (offsetTex) para a animação da spritesheet
+// A função retorna o programa ainda compilando (ver ShaderLibrary)
+ShaderFuture setupShader()
 {
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success) {
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
+	// Submete o programa à biblioteca de shaders sem esperar a compilação terminar
+	return spriteShaders.request(ShaderVariants::TEXTURED | ShaderVariants::ANIMATED);
 }
 
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a 
@@ -431,58 +457,49 @@ Sprite initializeSprite(GLuint texID, vec3 dimensions, vec3 position, float vel,
 	sprite.angle = angle;
 	sprite.iFrame = 0;
 	sprite.iAnimation = 0;
+	sprite.sheet = nullptr;
+	sprite.pixelScale = 1.0;
 
 	sprite.ds = 1.0 / (float)nFrames;
 	sprite.dt = 1.0 / (float)nAnimations;
+	sprite.node = scene.add();
 
-	GLfloat vertices[] = {
-		//x     y     z     s     t
-		//T0
-		-0.5 ,  0.5 , 0.0 , 0.0 , sprite.dt, //v0
-		-0.5 , -0.5 , 0.0 , 0.0 , 0.0, //v1
-		 0.5 ,  0.5 , 0.0 , sprite.ds, sprite.dt,  //v3	
-		//T1
-		-0.5 , -0.5 , 0.0 , 0.0 , 0.0, //v1
-		 0.5 , -0.5 , 0.0 , sprite.ds, 0.0, //v2
-		 0.5 ,  0.5 , 0.0 , sprite.ds, sprite.dt  //v3	
-	};
+	// Quad unitário com 4 vértices compactos (posição float2, coordenadas de textura unorm16)
+	// e o buffer de índices compartilhado (ver QuadMesh.h)
+	std::vector<QuadVertex> vertices;
+	QuadMesh::append(vertices, -0.5, -0.5, 0.5, 0.5, 0.0, 0.0, sprite.ds, sprite.dt);
+	sprite.VAO = QuadMesh::createVAO(vertices);
 
-	GLuint VBO, VAO;
-	//Geração do identificador do VBO
-	glGenBuffers(1, &VBO);
-	//Faz a conexão (vincula) do buffer como um buffer de array
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	//Envia os dados do array de floats para o buffer da OpenGl
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	//Geração do identificador do VAO (Vertex Array Object)
-	glGenVertexArrays(1, &VAO);
-	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-	// e os ponteiros para os atributos 
-	glBindVertexArray(VAO);
-	//Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo)
-
-	// Atributo posição - coord x, y, z - 3 valores
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid*)0);
-	glEnableVertexAttribArray(0);
-
-	// Atributo coordenada de textura - coord s, t - 2 valores
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(1);
+    return sprite;
+}
 
-	// Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice 
-	// atualmente vinculado - para que depois possamos desvincular com segurança
-	glBindBuffer(GL_ARRAY_BUFFER, 0); 
+// Inicialização de uma sprite cujos frames vêm de uma SpriteSheet: cada frame é um quad
+// do tamanho do seu retângulo recortado, então não há desenho do preenchimento transparente
+Sprite initializeSheetSprite(GLuint texID, SpriteSheet &sheet, float pixelScale, vec3 dimensions, vec3 position, float vel, float angle)
+{
+	Sprite sprite;
 
-	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0); 
+	sprite.texID = texID;
+	sprite.dimensions = dimensions;
+	sprite.pos = position;
+	sprite.nAnimations = sheet.animations.size();
+	sprite.nFrames = sheet.animations.empty() ? 1 : sheet.animations[0].nFrames;
+	sprite.vel = vel;
+	sprite.angle = angle;
+	sprite.iFrame = 0;
+	sprite.iAnimation = 0;
+	sprite.ds = 0.0;
+	sprite.dt = 0.0;
+	sprite.sheet = &sheet;
+	sprite.pixelScale = pixelScale;
+	sprite.node = scene.add();
 
-	sprite.VAO = VAO;
+	sprite.VAO = sheet.createVAO();
 
-    return sprite;
+	return sprite;
 }
 
-void drawTriangle(GLuint shaderID, GLuint VAO, vec3 position, vec3 dimensions, float angle, vec3 color, vec3 axis)
+void drawTriangle(Shader &shader, GLuint VAO, vec3 position, vec3 dimensions, float angle, vec3 color, vec3 axis)
 {
 	//Matriz de modelo: transformações na geometria (objeto)
 	mat4 model = mat4(1); //matriz identidade
@@ -492,9 +509,9 @@ void drawTriangle(GLuint shaderID, GLuint VAO, vec3 position, vec3 dimensions, f
 	model = rotate(model,radians(angle),axis);
 	//Escala
 	model = scale(model,dimensions);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+	shader.setMat4("model", value_ptr(model));
 
-	glUniform4f(glGetUniformLocation(shaderID, "inputColor"), color.r, color.g, color.b , 1.0f); //enviando cor para variável uniform inputColor
+	shader.setVec4("inputColor", color.r, color.g, color.b , 1.0f); //enviando cor para variável uniform inputColor
 		// Chamada de desenho - drawcall
 		// Poligono Preenchido - GL_TRIANGLES
 	glDrawArrays(GL_TRIANGLES, 0, 3);
@@ -523,14 +540,15 @@ GLuint loadTexture(string filePath, int &width, int &height)
 
 	if (data) 
 	{ 
-		if (nrChannels== 3) //jpg, bmp    
-		{ 
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);    
-		}    
-		else // assume que é 4 canais png    
-		{ 
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    	}    
+		// Expande para 4 canais, pré-multiplica o alfa e troca para BGRA antes do upload
+		vector<unsigned char> scratch;
+		PixelOps::Stats stats;
+		unsigned char *pixels = PixelOps::prepareTexture(data, width, height, nrChannels, true, scratch, &stats);
+		cout << filePath << ": " << width << "x" << height << " (" << nrChannels << " canais) em "
+			<< stats.seconds * 1000.0 << " ms, " << stats.mpixPerSec() << " MPix/s ["
+			<< PixelOps::isaName(PixelOps::detectIsa()) << "]" << endl;
+
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, pixels);
 		glGenerateMipmap(GL_TEXTURE_2D); 
 	} 
 	else 
@@ -544,48 +562,66 @@ GLuint loadTexture(string filePath, int &width, int &height)
     return texID;
 }
 
-void drawSprite(GLuint shaderID, Sprite &sprite)
+void drawSprite(Shader &shader, Sprite &sprite)
 {
 	glBindVertexArray(sprite.VAO); //Conectando ao buffer de geometria
 	glBindTexture(GL_TEXTURE_2D, sprite.texID); // conectando com o buffer de textura que será usado no draw call 
 
-	//Matriz de modelo: transformações na geometria (objeto)
-	mat4 model = mat4(1); //matriz identidade
-	//Translação
-	model = translate(model,sprite.pos);
-	//Rotação 
-	model = rotate(model,radians(sprite.angle), vec3(0.0, 0.0, 1.0));
-	//Escala
-	model = scale(model,sprite.dimensions);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+	//Matriz de modelo: translação, rotação e escala, vinda do grafo de cena (recalculada só
+	//quando alguma delas muda). Frame recortado: o quad já está em pixels, com a origem no pivô
+	vec3 spriteScale = sprite.sheet ? vec3(sprite.pixelScale, sprite.pixelScale, 1.0) : sprite.dimensions;
+	scene.setTransform(sprite.node, sprite.pos, radians(sprite.angle), spriteScale);
+	const mat4 &model = scene.world(sprite.node);
+	shader.setMat4("model", value_ptr(model));
 
-	// Chamada de desenho - drawcall
-	// Poligono Preenchido - GL_TRIANGLES
-	glDrawArrays(GL_TRIANGLES, 0, 6);
+	if (sprite.sheet)
+	{
+		const SpriteSheet::Animation &anim = sprite.sheet->animations[sprite.iAnimation];
+		int frame = anim.firstFrame + sprite.iFrame % anim.nFrames;
+		QuadMesh::draw(frame, 1);
+	}
+	else
+	{
+		// Chamada de desenho - drawcall
+		// Quad indexado - GL_TRIANGLES
+		QuadMesh::draw(0, 1);
+	}
 
 	glBindVertexArray(0); // Desconectando ao buffer de geometria
 	glBindTexture(GL_TEXTURE_2D, 0); // Desconectando com o buffer de textura
 }
 
-void updateSprite(GLuint shaderID, Sprite &sprite)
+void updateSprite(Shader &shader, Sprite &sprite)
 {
 	// Incrementa o índice do frame apenas quando fecha a taxa de FPS desejada
 	float now = glfwGetTime();
 	float dt = now - lastTime;
+	if (sprite.sheet)
+	{
+		// Cada animação da spritesheet pode ter um número diferente de frames
+		sprite.nFrames = sprite.sheet->animations[sprite.iAnimation].nFrames;
+	}
 	if (dt >= 1 / FPS)
 	{
 		sprite.iFrame = (sprite.iFrame + 1) % sprite.nFrames;
 		lastTime = now;
 	}
+
+	if (sprite.sheet)
+	{
+		// As coordenadas de textura de cada frame já estão no VAO
+		shader.setVec2("offsetTex", 0.0, 0.0);
+		return;
+	}
 	
 	vec2 offsetTex;
 	offsetTex.s = sprite.iFrame * sprite.ds;
 	offsetTex.t = sprite.iAnimation * sprite.dt;
 
-	glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), offsetTex.s, offsetTex.t); // Enviando cor para a variável uniform offsetTex
+	shader.setVec2("offsetTex", offsetTex.s, offsetTex.t); // Enviando cor para a variável uniform offsetTex
 }
 
-void moveSprite(GLuint shaderID, Sprite &sprite)
+void moveSprite(Shader &shader, Sprite &sprite)
 {
 	if (keys[GLFW_KEY_A] || keys[GLFW_KEY_LEFT])
 	{
@@ -593,7 +629,7 @@ void moveSprite(GLuint shaderID, Sprite &sprite)
 		{
 			sprite.pos.x -= sprite.vel;
 		}
-		sprite.iAnimation = 1;
+		setAnimation(sprite, 1);
 	}
 	if (keys[GLFW_KEY_D] || keys[GLFW_KEY_RIGHT])
 	{
@@ -601,15 +637,23 @@ void moveSprite(GLuint shaderID, Sprite &sprite)
 		{
 			sprite.pos.x += sprite.vel;
 		}
-		sprite.iAnimation = 2;
+		setAnimation(sprite, 2);
 	}
 	if (!keys[GLFW_KEY_A] && !keys[GLFW_KEY_D] && !keys[GLFW_KEY_LEFT] && !keys[GLFW_KEY_RIGHT])
 	{
-		sprite.iAnimation = 3;
+		// Animação 0 = parado (na grade uniforme de 3 linhas, 0 e 3 caem na mesma linha da textura)
+		setAnimation(sprite, 0);
 	}
 }
 
-void updateSnowball(GLuint shaderID, Sprite &sprite)
+// Troca a animação da sprite, limitada às animações que ela tem (uma spritesheet pode ter
+// menos animações do que as usadas pelo movimento)
+void setAnimation(Sprite &sprite, int iAnimation)
+{
+	sprite.iAnimation = std::max(0, std::min(iAnimation, sprite.nAnimations - 1));
+}
+
+void updateSnowball(Shader &shader, Sprite &sprite)
 {
 	sprite.vel += 0.0000015;
 	if (sprite.pos.y > 50)
@@ -623,7 +667,7 @@ void updateSnowball(GLuint shaderID, Sprite &sprite)
     }
 }
 
-void updateItems(GLuint shaderID, Sprite & sprite)
+void updateItems(Shader &shader, Sprite & sprite)
 {
 	sprite.vel += 0.0000015;
 	if (sprite.pos.y > 50)